@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <array>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "../include/algorithm.hpp"
+#include "../include/numeric.hpp"
+#include "perf.hpp"
+
+int main(int argc, const char * argv[]) {
+	const size_t n = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 1 << 22;
+	const size_t reps = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 8;
+	const size_t queries = 1 << 16;
+
+	std::vector<int> v(n);
+	loop::iota(v.begin(), v.end(), 0);
+	std::vector<int> w(n);
+	std::vector<int> q(queries);
+	loop::random::xoshiro256pp g{1};
+	loop::generate(q.begin(), q.end(),
+		       [&g, n]() { return loop::random::bounded(g, n); });
+
+	printf("# n = %zu, reps = %zu\n", n, reps);
+	bench::header();
+
+	// binary_recurse
+	bench::run("lower_bound", queries, reps, [&]() {
+		for (int k : q)
+			bench::keep(loop::lower_bound(v.begin(), v.end(), k));
+	});
+	bench::run("lower_bound (interpolation)", queries, reps, [&]() {
+		for (int k : q)
+			bench::keep(loop::lower_bound(loop::interpolation,
+						      v.begin(), v.end(), k));
+	});
+	bench::run("lower_bound (exponential)", queries, reps, [&]() {
+		for (int k : q)
+			bench::keep(loop::lower_bound(loop::exponential,
+						      v.begin(), v.end(), k));
+	});
+	bench::run("upper_bound", queries, reps, [&]() {
+		for (int k : q)
+			bench::keep(loop::upper_bound(v.begin(), v.end(), k));
+	});
+	bench::run("binary_search", queries, reps, [&]() {
+		for (int k : q)
+			bench::keep(loop::binary_search(v.begin(), v.end(), k));
+	});
+	bench::run("equal_range", queries, reps, [&]() {
+		for (int k : q)
+			bench::keep(loop::equal_range(v.begin(), v.end(), k));
+	});
+
+	// range_while
+	bench::run("find", n, reps, [&]() {
+		bench::keep(loop::find(v.begin(), v.end(), -1));
+	});
+	bench::run("count_if", n, reps, [&]() {
+		bench::keep(loop::count_if(v.begin(), v.end(),
+					   [](int x) { return x & 1; }));
+	});
+	bench::run("all_of", n, reps, [&]() {
+		bench::keep(loop::all_of(v.begin(), v.end(), loop::fn::gt(-1)));
+	});
+	bench::run("copy", n, reps, [&]() {
+		bench::keep(loop::copy(v.begin(), v.end(), w.begin()));
+	});
+	bench::run("is_sorted", n, reps, [&]() {
+		bench::keep(loop::is_sorted(v.begin(), v.end()));
+	});
+	bench::run("adjacent_find", n, reps, [&]() {
+		bench::keep(loop::adjacent_find(v.begin(), v.end()));
+	});
+	bench::run("unique_copy", n, reps, [&]() {
+		bench::keep(loop::unique_copy(v.begin(), v.end(), w.begin()));
+	});
+	bench::run("adjacent_difference", n, reps, [&]() {
+		bench::keep(loop::adjacent_difference(v.begin(), v.end(),
+						      w.begin()));
+	});
+	std::vector<unsigned char> bytes(n);
+	loop::generate(bytes.begin(), bytes.end(), [&g]() { return g(); });
+	std::vector<size_t> bins(256);
+	bench::run("histogram (bytes)", n, reps, [&]() {
+		loop::histogram(bytes.begin(), bytes.end(), bins.begin(),
+				bins.end());
+		bench::keep(bins);
+	});
+	std::vector<int> scores(n);
+	loop::generate(scores.begin(), scores.end(), [&g]() { return g(); });
+	std::vector<int> top(1 << 14);
+	bench::run("top_k 100 (heap)", n, reps, [&]() {
+		bench::keep(loop::top_k(scores.begin(), scores.end(), 100,
+					top.begin(), std::greater{}));
+	});
+	bench::run("top_k 16384 (batch)", n, reps, [&]() {
+		bench::keep(loop::top_k(scores.begin(), scores.end(), top.size(),
+					top.begin(), std::greater{}));
+	});
+	bench::run("top_k 16384 (heap)", n, reps, [&]() {
+		bench::keep(loop::top_k_heap(scores.begin(), scores.end(),
+					     top.size(), top.begin(),
+					     std::greater{}));
+	});
+	bench::run("minmax_element", n, reps, [&]() {
+		bench::keep(loop::minmax_element(v.begin(), v.end()));
+	});
+
+	// sorting networks: n / 16 random arrays, refilled before each pass
+	std::vector<std::array<int, 16>> small(n / 16);
+	auto refill = [&small, &scores]() {
+		for (size_t i = 0; i < small.size(); ++i)
+			loop::copy(scores.begin() + 16 * i,
+				   scores.begin() + 16 * (i + 1),
+				   small[i].begin());
+	};
+	bench::run("refill array<int, 16>", n, reps, [&]() {
+		refill();
+		bench::keep(small);
+	});
+	bench::run("sort array<int, 16>", n, reps, [&]() {
+		refill();
+		for (auto & a : small) loop::sort(a);
+		bench::keep(small);
+	});
+	bench::run("std::sort array<int, 16>", n, reps, [&]() {
+		refill();
+		for (auto & a : small) std::sort(a.begin(), a.end());
+		bench::keep(small);
+	});
+
+	// indexed
+	std::vector<uint32_t> perm(n);
+	loop::iota(perm.begin(), perm.end(), 0);
+	loop::shuffle(perm.begin(), perm.end(), g);
+	std::vector<uint64_t> col(n), dst(n);
+	loop::iota(col.begin(), col.end(), 0);
+	bench::run("gather (no prefetch)", n, reps, [&]() {
+		loop::gather(perm.begin(), perm.end(), col.begin(), dst.begin(),
+			     0);
+		bench::keep(dst);
+	});
+	bench::run("gather", n, reps, [&]() {
+		loop::gather(perm.begin(), perm.end(), col.begin(), dst.begin());
+		bench::keep(dst);
+	});
+	bench::run("gather (blocked)", n, reps, [&]() {
+		loop::gather(loop::blocked, perm.begin(), perm.end(),
+			     col.begin(), col.end(), dst.begin());
+		bench::keep(dst);
+	});
+	bench::run("scatter", n, reps, [&]() {
+		loop::scatter(col.begin(), col.end(), perm.begin(), dst.begin());
+		bench::keep(dst);
+	});
+	bench::run("scatter (blocked)", n, reps, [&]() {
+		loop::scatter(loop::blocked, col.begin(), col.end(),
+			      perm.begin(), dst.begin(), dst.end());
+		bench::keep(dst);
+	});
+	bench::run("apply_permutation", n, reps, [&]() {
+		loop::apply_permutation(dst.begin(), dst.end(), perm.begin());
+		bench::keep(dst);
+	});
+
+	// numeric folds
+	bench::run("accumulate", n, reps, [&]() {
+		bench::keep(
+		    loop::accumulate(v.begin(), v.end(), 0L, std::plus{}));
+	});
+	bench::run("inner_product", n, reps, [&]() {
+		bench::keep(loop::inner_product(v.begin(), v.end(), w.begin(),
+						0L, std::plus{},
+						std::multiplies{}));
+	});
+	bench::run("inclusive_scan", n, reps, [&]() {
+		bench::keep(loop::inclusive_scan(v.begin(), v.end(), w.begin(),
+						 0, std::plus{}));
+	});
+
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../include/external.hpp"
+#include "../include/numeric.hpp"
+
+// Usage: ./external.out [records] [memory bytes] [directory]
+int main(int argc, const char * argv[]) {
+	const size_t n = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 1 << 28;
+	const size_t memory =
+	    (argc > 2) ? strtoull(argv[2], nullptr, 0) : 1 << 28;
+	const char * dir = (argc > 3) ? argv[3] : "/tmp";
+
+	char in[4096], out[4096];
+	snprintf(in, sizeof(in), "%s/loop_stl_external.in", dir);
+	snprintf(out, sizeof(out), "%s/loop_stl_external.out", dir);
+
+	uint64_t sum = 0;
+	{
+		loop::external::mapped<uint64_t> m{in, n};
+		loop::random::xoshiro256pp g{1};
+		loop::generate(m.begin(), m.end(), [&g]() { return g(); });
+		sum = loop::accumulate(m.begin(), m.end(), uint64_t{0},
+				       std::plus{});
+	}
+
+	auto t0 = std::chrono::steady_clock::now();
+	loop::external::sort<uint64_t>(in, out, memory);
+	auto t1 = std::chrono::steady_clock::now();
+
+	loop::external::mapped<uint64_t> m{out};
+	const bool ok = (m.size() == n) &&
+			loop::is_sorted(m.begin(), m.end()) &&
+			(sum == loop::accumulate(m.begin(), m.end(),
+						 uint64_t{0}, std::plus{}));
+	printf("%zu records (%zu MiB) with %zu MiB of memory: %.2f s, %s\n",
+	       n, n * sizeof(uint64_t) >> 20, memory >> 20,
+	       std::chrono::duration<double>(t1 - t0).count(),
+	       ok ? "sorted" : "FAILED");
+	remove(in);
+	remove(out);
+	return ok ? 0 : 1;
+}
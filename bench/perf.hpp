@@ -0,0 +1,184 @@
+#ifndef LOOP_STL_BENCH_PERF_HPP
+#define LOOP_STL_BENCH_PERF_HPP
+
+#include <array>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+
+/* -----------------------
+ * Hardware counters
+ *
+ * Each event is opened on its own, so a kernel or container that only
+ * exposes some of them still reports the rest. Events that cannot be
+ * opened print as "-", and wall-clock time is always available.
+ * ----------------------
+ */
+
+enum event : size_t {
+	cycles,
+	instructions,
+	branch_misses,
+	l1d_misses,
+	llc_misses,
+	events
+};
+
+struct sample {
+	double ns = 0;
+	std::array<double, events> count{};
+	std::array<bool, events> valid{};
+};
+
+#if defined(__linux__)
+
+constexpr uint64_t cache_miss(uint64_t cache) {
+	return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+	       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+struct counters {
+	std::array<int, events> fd{};
+
+	counters() {
+		const std::array<std::pair<uint32_t, uint64_t>, events> cfg{{
+		    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+		    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+		    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+		    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+		    {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+		}};
+		for (size_t e = 0; e < events; ++e) {
+			perf_event_attr attr{};
+			attr.size = sizeof(attr);
+			attr.type = cfg[e].first;
+			attr.config = cfg[e].second;
+			attr.disabled = 1;
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED |
+					   PERF_FORMAT_TOTAL_TIME_RUNNING;
+			fd[e] = syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+					0);
+		}
+	}
+	counters(const counters &) = delete;
+	counters & operator=(const counters &) = delete;
+	~counters() {
+		for (int f : fd)
+			if (f >= 0) close(f);
+	}
+
+	bool any() const {
+		for (int f : fd)
+			if (f >= 0) return true;
+		return false;
+	}
+
+	void start() {
+		for (int f : fd) {
+			if (f < 0) continue;
+			ioctl(f, PERF_EVENT_IOC_RESET, 0);
+			ioctl(f, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	void stop(sample & s) {
+		for (size_t e = 0; e < events; ++e) {
+			if (fd[e] < 0) continue;
+			ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+			uint64_t buf[3] = {};
+			if (read(fd[e], buf, sizeof(buf)) != sizeof(buf) ||
+			    buf[2] == 0)
+				continue;
+			// Scale for multiplexing when events outnumber PMUs
+			s.count[e] = static_cast<double>(buf[0]) * buf[1] /
+				     buf[2];
+			s.valid[e] = true;
+		}
+	}
+};
+
+#else
+
+struct counters {
+	bool any() const { return false; }
+	void start() {}
+	void stop(sample &) {}
+};
+
+#endif
+
+inline counters & pmu() {
+	static counters c{};
+	return c;
+}
+
+template <typename Fn0>
+sample measure(size_t reps, Fn0 fn0) {
+	sample s{};
+	fn0();
+	auto t0 = std::chrono::steady_clock::now();
+	pmu().start();
+	for (size_t r = 0; r < reps; ++r) fn0();
+	pmu().stop(s);
+	auto t1 = std::chrono::steady_clock::now();
+	s.ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+	s.ns /= reps;
+	for (auto & c : s.count) c /= reps;
+	return s;
+}
+
+inline void header() {
+	printf("%-28s %10s %9s %9s %6s %10s %10s %10s\n", "per element",
+	       "ns", "cycles", "instr", "IPC", "br-miss", "L1D-miss",
+	       "LLC-miss");
+	if (!pmu().any())
+		printf("# perf_event_open unavailable: wall-clock only\n");
+}
+
+inline void column(const sample & s, event e, size_t n, int width, int prec) {
+	if (s.valid[e])
+		printf(" %*.*f", width, prec, s.count[e] / n);
+	else
+		printf(" %*s", width, "-");
+}
+
+inline void report(const char * name, size_t n, const sample & s) {
+	printf("%-28s %10.3f", name, s.ns / n);
+	column(s, cycles, n, 9, 3);
+	column(s, instructions, n, 9, 3);
+	if (s.valid[cycles] && s.valid[instructions])
+		printf(" %6.2f", s.count[instructions] / s.count[cycles]);
+	else
+		printf(" %6s", "-");
+	column(s, branch_misses, n, 10, 4);
+	column(s, l1d_misses, n, 10, 4);
+	column(s, llc_misses, n, 10, 4);
+	printf("\n");
+}
+
+template <typename T>
+inline void keep(const T & val) {
+	asm volatile("" : : "g"(&val) : "memory");
+}
+
+template <typename Fn0>
+void run(const char * name, size_t n, size_t reps, Fn0 fn0) {
+	bench::report(name, n, bench::measure(reps, fn0));
+}
+
+} // namespace bench
+
+#endif // !LOOP_STL_BENCH_PERF_HPP
@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "../include/algorithm.hpp"
+#include "../include/numeric.hpp"
+#include "perf.hpp"
+
+// Usage: ./scaling.out [n] [reps] [max threads]
+int main(int argc, const char * argv[]) {
+	const size_t n = (argc > 1) ? strtoull(argv[1], nullptr, 0) : 1 << 24;
+	const size_t reps = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 4;
+	const size_t max = (argc > 3) ? strtoull(argv[3], nullptr, 0)
+				      : std::thread::hardware_concurrency();
+
+	std::vector<uint64_t> v(n), w(n), o(2 * n);
+	loop::random::xoshiro256pp g{1};
+	loop::generate(v.begin(), v.end(), [&g]() { return g(); });
+	loop::generate(w.begin(), w.end(), [&g]() { return g(); });
+	auto a = v, b = w;
+	loop::sort(a.begin(), a.end());
+	loop::sort(b.begin(), b.end());
+
+	printf("# n = %zu, reps = %zu\n", n, reps);
+	printf("%-8s %14s %8s %14s %8s\n", "threads", "sort ns/elem", "speedup",
+	       "merge ns/elem", "speedup");
+	double sort1 = 0, merge1 = 0;
+	// Powers of two, then the full count when it is not one
+	for (size_t t = 1; t <= std::max<size_t>(1, max);
+	     t = (t < max && 2 * t > max) ? max : 2 * t) {
+		const loop::parallel_policy par{t};
+		auto s = bench::measure(reps, [&]() {
+			loop::copy(v.cbegin(), v.cend(), w.begin());
+			loop::sort(par, w.begin(), w.end());
+			bench::keep(w);
+		});
+		auto m = bench::measure(reps, [&]() {
+			bench::keep(loop::merge(par, a.cbegin(), a.cend(),
+						b.cbegin(), b.cend(),
+						o.begin()));
+		});
+		if (t == 1) sort1 = s.ns, merge1 = m.ns;
+		printf("%-8zu %14.3f %8.2f %14.3f %8.2f\n", t, s.ns / n,
+		       sort1 / s.ns, m.ns / (2 * n), merge1 / m.ns);
+	}
+}
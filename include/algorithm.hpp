@@ -1,11 +1,23 @@
 #ifndef LOOP_STL_ALGORITHM_HPP
 #define LOOP_STL_ALGORITHM_HPP
 
+#include <array>
+#include <bit>
+#include <compare>
+#include <iterator>
+#include <numeric>
+#include <ranges>
 #include <stdlib.h>
+#include <string.h>
 #include <utility>
+#include <vector>
 
 #include "fn.hpp"
 #include "loop.hpp"
+#include "network.hpp"
+#include "parallel.hpp"
+#include "random.hpp"
+#include "simd.hpp"
 
 namespace loop {
 
@@ -35,6 +47,80 @@ constexpr size_t count(It f, It l, T val) {
 	return loop::count_if(f, l, fn::eq(val));
 }
 
+template <typename It, typename BinIt, typename Fn1>
+void histogram(It f, It l, BinIt bf, BinIt bl, Fn1 key) {
+	using T = typename std::iterator_traits<It>::value_type;
+	const size_t n = bl - bf;
+
+	// Four interleaved tables keep runs of one key from stalling on the
+	// store-to-load dependency of a single counter
+	constexpr size_t ways = 4;
+	if constexpr (simd::contiguous<It> && simd::byte<T> &&
+		      std::is_same_v<Fn1, std::identity>) {
+		uint32_t sub[ways][256] = {};
+		for (auto p = simd::ptr(f), q = simd::ptr(l); p != q;) {
+			auto e = p + std::min<size_t>(q - p, UINT32_MAX);
+			auto bytes = [&sub]<size_t... B>(uint64_t word,
+							 std::index_sequence<B...>) {
+				(++sub[B % ways][(word >> 8 * B) & 0xff], ...);
+			};
+			for (uint64_t word; e - p >= 8; p += 8) {
+				memcpy(&word, p, 8);
+				bytes(word, std::make_index_sequence<8>{});
+			}
+			for (; p != e; ++p) ++sub[0][static_cast<uint8_t>(*p)];
+			for (size_t b = 0; b < std::min<size_t>(n, 256); ++b) {
+				for (size_t w = 0; w < ways; ++w)
+					bf[b] += sub[w][b], sub[w][b] = 0;
+			}
+		}
+	} else if (n <= (1 << 16)) {
+		std::vector<size_t> sub(ways * n);
+		size_t i = 0;
+		loop::for_each(f, l, [&sub, &i, n, key](auto elt) {
+			const size_t k = std::invoke(key, elt);
+			if (k < n) ++sub[(i++ % ways) * n + k];
+		});
+		for (size_t b = 0; b < n; ++b) {
+			for (size_t w = 0; w < ways; ++w) bf[b] += sub[w * n + b];
+		}
+	} else {
+		loop::for_each(f, l, [bf, n, key](auto elt) {
+			const size_t k = std::invoke(key, elt);
+			if (k < n) ++bf[k];
+		});
+	}
+}
+
+template <typename It, typename BinIt>
+void histogram(It f, It l, BinIt bf, BinIt bl) {
+	loop::histogram(f, l, bf, bl, std::identity{});
+}
+
+template <typename It, typename BinIt, typename Fn1 = std::identity>
+void histogram(parallel_policy policy, It f, It l, BinIt bf, BinIt bl,
+	       Fn1 key = {}) {
+	const size_t n = l - f;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1) return loop::histogram(f, l, bf, bl, key);
+	const size_t bins = bl - bf;
+	std::vector<size_t> local(k * bins);
+	parallel::invoke(k, [&](size_t i) {
+		auto p = local.begin() + i * bins;
+		loop::histogram(f + parallel::split(n, k, i),
+				f + parallel::split(n, k, i + 1), p, p + bins,
+				key);
+	});
+	parallel::invoke(k, [&](size_t i) {
+		const size_t b = parallel::split(bins, k, i);
+		const size_t e = parallel::split(bins, k, i + 1);
+		for (size_t t = 0; t < k; ++t) {
+			for (size_t j = b; j != e; ++j)
+				bf[j] += local[t * bins + j];
+		}
+	});
+}
+
 template <typename It, typename If1>
 constexpr bool all_of(It f, It l, If1 if1) {
 	return loop::element_while(f, l, if1).ended();
@@ -78,9 +164,25 @@ constexpr std::pair<ItL, ItR> mismatch(ItL f, ItL l, ItR s, ItR t) {
 	return loop::parallel_while(f, l, s, t, std::equal_to{}).it;
 }
 
+template <typename It, typename If2>
+constexpr It adjacent_find(It f, It l, If2 if2) {
+	using T = std::iter_value_t<It>;
+	if constexpr (simd::contiguous<It> && std::is_arithmetic_v<T> &&
+		      fn::pure<If2>) {
+		if (!std::is_constant_evaluated() && f != l) {
+			const size_t n = l - f;
+			const size_t i =
+			    simd::adjacent(simd::ptr(f), n, fn::ifnot(if2));
+			return (i + 1 == n) ? l : f + i;
+		}
+	}
+	auto ret = loop::adjacent_while(f, l, fn::ifnot(if2));
+	return ret.found() ? ret.it.first : l;
+}
+
 template <typename It>
 constexpr It adjacent_find(It f, It l) {
-	return loop::adjacent_while(f, l, std::not_equal_to{}).it.first;
+	return loop::adjacent_find(f, l, std::equal_to{});
 }
 
 template <typename ItL, typename ItR>
@@ -146,6 +248,14 @@ constexpr OutIt rotate_copy(InIt f, InIt m, InIt l, OutIt out) {
 template <typename InIt, typename OutIt>
 constexpr OutIt unique_copy(InIt f, InIt l, OutIt out) {
 	if (f == l) return out;
+	using T = std::iter_value_t<InIt>;
+	if constexpr (simd::contiguous<InIt> && std::is_arithmetic_v<T>) {
+		if (!std::is_constant_evaluated()) {
+			return simd::output<T>(out, [&](auto o) {
+				return simd::unique(simd::ptr(f), l - f, o);
+			});
+		}
+	}
 	fn::writer(out)(*f);
 	auto wr = [](auto writer, auto lhs, auto rhs) {
 		if (rhs != lhs) std::invoke(writer, rhs);
@@ -174,7 +284,10 @@ constexpr OutIt replace_copy(InIt f, InIt l, OutIt out, T prev, T anew) {
 
 template <typename It, typename Fn0>
 constexpr void generate(It f, It l, Fn0 gen) {
-	loop::iterator_each(f, l, [gen](auto it) { *it = std::invoke(gen); });
+	loop::segment_each(f, l, [gen](auto f, auto l) {
+		loop::iterator_each(f, l,
+				    [gen](auto it) { *it = std::invoke(gen); });
+	});
 }
 
 template <typename It, typename T>
@@ -194,6 +307,384 @@ constexpr void fill_n(It f, size_t n, T val) {
 	loop::generate_n(f, n, [val]() { return val; });
 }
 
+template <typename ItL, typename ItR>
+constexpr void iter_swap(ItL lhs, ItR rhs) {
+	using std::swap;
+	swap(*lhs, *rhs);
+}
+
+template <typename InIt, typename OutIt>
+constexpr OutIt move(InIt f, InIt l, OutIt out) {
+	loop::iterator_each(f, l, [&out](auto it) {
+		*out = std::move(*it);
+		++out;
+	});
+	return out;
+}
+
+template <typename InIt, typename OutIt>
+constexpr OutIt move_backward(InIt f, InIt l, OutIt out) {
+	while (f != l) *--out = std::move(*--l);
+	return out;
+}
+
+template <typename It>
+constexpr void reverse(It f, It l) {
+	if constexpr (simd::contiguous<It>) {
+		if (!std::is_constant_evaluated())
+			return simd::reverse(simd::ptr(f), simd::ptr(l));
+	}
+	for (; f != l && f != --l; ++f) loop::iter_swap(f, l);
+}
+
+template <typename It>
+constexpr It rotate_swap(It f, It m, It l) {
+	It s = m;
+	do {
+		loop::iter_swap(f++, s++);
+		if (f == m) m = s;
+	} while (s != l);
+	It ret = f;
+	for (s = m; s != l;) {
+		loop::iter_swap(f++, s++);
+		if (f == m)
+			m = s;
+		else if (s == l)
+			s = m;
+	}
+	return ret;
+}
+
+template <typename It>
+constexpr It rotate_reverse(It f, It m, It l) {
+	loop::reverse(f, m);
+	loop::reverse(m, l);
+	for (; f != m && m != l; ++f) loop::iter_swap(f, --l);
+	if (f == m) {
+		loop::reverse(m, l);
+		return l;
+	} else {
+		loop::reverse(f, m);
+		return f;
+	}
+}
+
+template <typename It>
+constexpr It rotate_cycle(It f, It m, It l) {
+	const auto n = l - f;
+	const auto k = m - f;
+	for (auto i = std::gcd(n, k); i-- != 0;) {
+		auto tmp = std::move(f[i]);
+		auto j = i;
+		for (auto d = j + k;; d += k) {
+			if (d >= n) d -= n;
+			if (d == i) break;
+			f[j] = std::move(f[d]);
+			j = d;
+		}
+		f[j] = std::move(tmp);
+	}
+	return f + (n - k);
+}
+
+template <typename It>
+constexpr It rotate(It f, It m, It l) {
+	using T = typename std::iterator_traits<It>::value_type;
+	using category = typename std::iterator_traits<It>::iterator_category;
+	constexpr size_t buffer = 256 / sizeof(T);
+
+	if (f == m) return l;
+	if (m == l) return f;
+	if constexpr (std::is_base_of_v<std::random_access_iterator_tag,
+					category>) {
+		if constexpr (simd::contiguous<It> && buffer != 0) {
+			if (!std::is_constant_evaluated() &&
+			    std::min(m - f, l - m) <= ptrdiff_t{buffer}) {
+				alignas(T) unsigned char raw[sizeof(T) * buffer];
+				auto tmp = reinterpret_cast<T *>(raw);
+				auto p = simd::ptr(f), q = simd::ptr(m),
+				     r = simd::ptr(l);
+				if (q - p <= r - q) {
+					simd::shift(p, q, tmp);
+					simd::shift(q, r, p);
+					simd::shift(tmp, tmp + (q - p), p + (r - q));
+				} else {
+					simd::shift(q, r, tmp);
+					simd::shift(p, q, p + (r - q));
+					simd::shift(tmp, tmp + (r - q), p);
+				}
+				return f + (l - m);
+			}
+		}
+		if constexpr (sizeof(T) > simd::width)
+			return loop::rotate_cycle(f, m, l);
+		else
+			return loop::rotate_reverse(f, m, l);
+	} else if constexpr (std::is_base_of_v<std::bidirectional_iterator_tag,
+					       category>) {
+		return loop::rotate_reverse(f, m, l);
+	} else {
+		return loop::rotate_swap(f, m, l);
+	}
+}
+
+template <typename It>
+constexpr It shift_left(It f, It l, size_t n) {
+	if (n == 0) return l;
+	It m = f;
+	for (; n != 0; --n, ++m)
+		if (m == l) return f;
+	if constexpr (simd::contiguous<It>) {
+		if (!std::is_constant_evaluated()) {
+			auto p = simd::shift(simd::ptr(m), simd::ptr(l),
+					     simd::ptr(f));
+			return f + (p - simd::ptr(f));
+		}
+	}
+	return loop::move(m, l, f);
+}
+
+template <typename It>
+constexpr It shift_right(It f, It l, size_t n) {
+	if (n == 0) return f;
+	if constexpr (std::bidirectional_iterator<It>) {
+		It m = l;
+		for (; n != 0; --n, --m)
+			if (m == f) return l;
+		if constexpr (simd::contiguous<It>) {
+			if (!std::is_constant_evaluated()) {
+				auto p = simd::ptr(f);
+				simd::shift(p, simd::ptr(m), p + (l - m));
+				return f + (l - m);
+			}
+		}
+		return loop::move_backward(f, m, l);
+	} else {
+		const size_t len = std::distance(f, l);
+		if (n >= len) return l;
+		return loop::rotate(f, std::next(f, len - n), l);
+	}
+}
+
+// Indexed
+
+// out[k] = src[idx[k]]
+template <typename IdxIt, typename It, typename OutIt>
+OutIt gather(IdxIt f, IdxIt l, It src, OutIt out,
+	     size_t distance = simd::prefetch_distance) {
+	const size_t n = l - f;
+	size_t k = 0;
+	auto wr1 = [f, &k, n, src, distance](auto writer, auto i) {
+		if (k + distance < n)
+			simd::prefetch(std::addressof(src[f[k + distance]]));
+		++k;
+		std::invoke(writer, src[i]);
+	};
+	return loop::copy_each(f, l, out, wr1);
+}
+
+// out[idx[k]] = f[k]
+template <typename It, typename IdxIt, typename OutIt>
+void scatter(It f, It l, IdxIt idx, OutIt out,
+	     size_t distance = simd::prefetch_distance) {
+	const size_t n = std::distance(f, l);
+	size_t k = 0;
+	loop::for_each(f, l, [&k, n, idx, out, distance](auto elt) {
+		if (k + distance < n)
+			simd::prefetch<1>(std::addressof(out[idx[k + distance]]));
+		out[idx[k++]] = elt;
+	});
+}
+
+struct radix_blocked {};
+inline constexpr radix_blocked blocked{};
+
+// Indices are radix-partitioned by their high bits first, so each partition
+// only touches a cache_block of the indexed range
+template <typename T>
+size_t partition_shift(size_t m) {
+	const size_t block = std::bit_width(simd::cache_block / sizeof(T)) - 1;
+	const size_t fan = std::bit_width(m) - std::min<size_t>(
+						      std::bit_width(m), 10);
+	return std::max(block, fan);
+}
+
+template <typename IdxIt, typename It, typename OutIt>
+OutIt gather(radix_blocked, IdxIt f, IdxIt l, It src_f, It src_l, OutIt out) {
+	using T = std::iter_value_t<It>;
+	using I = std::iter_value_t<IdxIt>;
+	const size_t n = l - f, m = src_l - src_f;
+	const size_t shift = loop::partition_shift<T>(m);
+	if ((m >> shift) < 2) return loop::gather(f, l, src_f, out);
+	const size_t parts = ((m - 1) >> shift) + 1;
+
+	std::vector<size_t> off(parts + 1);
+	loop::for_each(f, l, [&off, shift](I i) { ++off[(i >> shift) + 1]; });
+	for (size_t p = 1; p <= parts; ++p) off[p] += off[p - 1];
+	std::vector<I> part(n);
+	auto next = off;
+	loop::for_each(f, l, [&next, &part, shift](I i) {
+		part[next[i >> shift]++] = i;
+	});
+	std::vector<T> vals{};
+	vals.reserve(n);
+	loop::gather(part.begin(), part.end(), src_f, std::back_inserter(vals));
+	next = off;
+	auto wr1 = [&next, &vals, shift](auto writer, I i) {
+		std::invoke(writer, vals[next[i >> shift]++]);
+	};
+	return loop::copy_each(f, l, out, wr1);
+}
+
+template <typename It, typename IdxIt, typename OutIt>
+void scatter(radix_blocked, It f, It l, IdxIt idx, OutIt out_f, OutIt out_l) {
+	using T = std::iter_value_t<It>;
+	using I = std::iter_value_t<IdxIt>;
+	const size_t n = l - f, m = out_l - out_f;
+	const size_t shift = loop::partition_shift<T>(m);
+	if ((m >> shift) < 2) return loop::scatter(f, l, idx, out_f);
+	const size_t parts = ((m - 1) >> shift) + 1;
+
+	std::vector<size_t> next(parts + 1);
+	loop::for_each(idx, idx + n, [&next, shift](I i) {
+		++next[(i >> shift) + 1];
+	});
+	for (size_t p = 1; p <= parts; ++p) next[p] += next[p - 1];
+	std::vector<I> part_i(n);
+	std::vector<T> part_v(n);
+	size_t k = 0;
+	loop::for_each(f, l, [&k, &next, &part_i, &part_v, idx, shift](T elt) {
+		const size_t pos = next[idx[k] >> shift]++;
+		part_i[pos] = idx[k++];
+		part_v[pos] = elt;
+	});
+	loop::scatter(part_v.begin(), part_v.end(), part_i.begin(), out_f);
+}
+
+// f[k] = old f[idx[k]], following each cycle of the permutation once; each
+// step waits on the previous one, so when a second buffer fits, gather into
+// it is several times faster
+template <typename It, typename IdxIt>
+void apply_permutation(It f, It l, IdxIt idx) {
+	const size_t n = l - f;
+	std::vector<uint64_t> done((n + 63) / 64);
+	auto visit = [&done](size_t i) {
+		done[i / 64] |= uint64_t{1} << (i % 64);
+	};
+	for (size_t w = 0; w < done.size(); ++w) {
+		for (int c; (c = std::countr_one(done[w])) != 64;) {
+			const size_t s = 64 * w + c;
+			if (s >= n) break;
+			auto tmp = std::move(f[s]);
+			size_t j = s;
+			for (size_t k = idx[j]; k != s;) {
+				const size_t next = idx[k];
+				simd::prefetch(std::addressof(f[next]));
+				f[j] = std::move(f[k]);
+				visit(j);
+				j = k, k = next;
+			}
+			f[j] = std::move(tmp);
+			visit(j);
+		}
+	}
+}
+
+// Random
+
+template <typename It, typename Fn1>
+constexpr void random_shuffle(It f, It l, Fn1 && r) {
+	loop::iterator_each(f, l, [&r, l](auto it) {
+		loop::iter_swap(it, std::next(it, std::invoke(r, l - it)));
+	});
+}
+
+template <typename It, typename G>
+constexpr void shuffle(It f, It l, G && g) {
+	loop::random_shuffle(f, l, [&g](auto n) {
+		return static_cast<decltype(n)>(random::bounded(g, n));
+	});
+}
+
+template <typename It, typename G>
+constexpr void merge_shuffle(It f, It m, It l, G && g) {
+	auto coin = random::coin<std::remove_reference_t<G>>{g};
+	const It s = f;
+	for (;; ++f) {
+		if (coin()) {
+			if (m == l) break;
+			loop::iter_swap(f, m);
+			++m;
+		} else if (f == m) {
+			break;
+		}
+	}
+	loop::iterator_each(f, l, [&g, s](auto it) {
+		loop::iter_swap(it, std::next(s, random::bounded(g, it - s + 1)));
+	});
+}
+
+template <typename It, typename G>
+void shuffle(parallel_policy policy, It f, It l, G && g) {
+	const size_t n = l - f;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1) return loop::shuffle(f, l, g);
+
+	std::vector<random::xoshiro256pp> gens(k, random::xoshiro256pp{g()});
+	for (size_t i = 1; i < k; ++i) (gens[i] = gens[i - 1]).jump();
+
+	parallel::invoke(k, [=, &gens](size_t i) {
+		loop::shuffle(f + parallel::split(n, k, i),
+			      f + parallel::split(n, k, i + 1), gens[i]);
+	});
+	// Merging stays uniform for halves of unequal length
+	auto fn4 = [f, &gens](size_t j, size_t a, size_t b, size_t c) {
+		if (b != c) loop::merge_shuffle(f + a, f + b, f + c, gens[j]);
+	};
+	parallel::rounds(n, k, fn4, [] {});
+}
+
+template <typename It, typename St, typename OutIt, typename G>
+OutIt reservoir_sample(It f, St l, OutIt out, size_t n, G && g) {
+	if (n == 0) return out;
+	size_t i = 0, skip = 0;
+	double w = 1;
+	auto next = [n, &g, &w, &skip]() {
+		w *= exp(log(random::unit(g)) / n);
+		const double s = floor(log(random::unit(g)) / log1p(-w));
+		skip = (s < 0x1.0p63) ? static_cast<size_t>(s) : SIZE_MAX;
+	};
+	auto br1 = [n, &g, &i, &skip, &next, out](auto elt) {
+		if (i < n) {
+			out[i++] = elt;
+			if (i == n) next();
+		} else if (skip-- == 0) {
+			out[random::bounded(g, n)] = elt;
+			next();
+		}
+		return true;
+	};
+	loop::element_while(f, l, br1);
+	return std::next(out, i);
+}
+
+template <typename It, typename OutIt, typename G>
+OutIt sample(It f, It l, OutIt out, size_t n, G && g) {
+	using category = typename std::iterator_traits<It>::iterator_category;
+	if constexpr (!std::is_base_of_v<std::forward_iterator_tag, category>) {
+		return loop::reservoir_sample(f, l, out, n, g);
+	} else {
+		size_t left = std::distance(f, l);
+		auto g1 = fn::guard([&n](auto) { return (n == 0); },
+				    [&n, &g, &left, w = fn::writer(out)](auto elt) {
+					    if (random::bounded(g, left--) < n)
+						    w(elt), --n;
+				    });
+		loop::element_while(f, l, g1);
+		return out;
+	}
+}
+
 // Min/Max
 
 template <typename It>
@@ -204,30 +695,56 @@ struct minmax {
 template <typename It>
 constexpr minmax<It> minmax_element(It f, It l) {
 	if (f == l) return {l, l};
-	It max = f;
 	It min = f;
-	++f;
-	loop::iterator_each(f, l, [&max, &min](auto it) {
-		if (*it > *max) max = it;
-		if (*it < *min) min = it;
-	});
+	It max = f;
+	auto fn2 = [&min, &max](It lo, It hi) {
+		if (*hi < *lo) std::swap(lo, hi);
+		if (*lo < *min) min = lo;
+		if (!(*hi < *max)) max = hi;
+	};
+	for (++f; f != l; ++f) {
+		It s = f;
+		if (++f == l) {
+			fn2(s, s);
+			break;
+		}
+		fn2(s, f);
+	}
 	return {min, max};
 }
 
 template <typename It>
 constexpr It max_element(It f, It l) {
-	return loop::minmax_element(f, l).max;
+	if (f == l) return l;
+	It max = f;
+	loop::iterator_each(++f, l, [&max](auto it) {
+		if (*max < *it) max = it;
+	});
+	return max;
 }
 
 template <typename It>
 constexpr It min_element(It f, It l) {
-	return loop::minmax_element(f, l).min;
+	if (f == l) return l;
+	It min = f;
+	loop::iterator_each(++f, l, [&min](auto it) {
+		if (*it < *min) min = it;
+	});
+	return min;
 }
 
 // Comparision
 
 template <typename ItL, typename ItR>
 constexpr bool equal(ItL f, ItL l, ItR s) {
+	if constexpr (simd::comparable<ItL, ItR>) {
+		if (!std::is_constant_evaluated()) {
+			// memcmp takes no null pointers, even for 0 bytes
+			if (f == l) return true;
+			return 0 == memcmp(simd::ptr(f), simd::ptr(s),
+					   (l - f) * sizeof(*f));
+		}
+	}
 	auto g = fn::guard([&s](auto elt) { return (elt != *s); },
 			   [&s](auto) { ++s; });
 	return loop::all_of(f, l, g);
@@ -235,7 +752,77 @@ constexpr bool equal(ItL f, ItL l, ItR s) {
 
 template <typename ItL, typename ItR>
 constexpr bool equal(ItL f, ItL l, ItR s, ItR t) {
-	return loop::parallel_while(f, l, s, t, std::equal_to{}).ended();
+	if constexpr (simd::comparable<ItL, ItR>) {
+		if (!std::is_constant_evaluated())
+			return (l - f == t - s) && loop::equal(f, l, s);
+	}
+	auto [i, j] = loop::parallel_while(f, l, s, t, std::equal_to{}).it;
+	return (i == l) && (j == t);
+}
+
+template <typename ItL, typename ItR, typename Cmp>
+constexpr auto lexicographical_compare_three_way(ItL f, ItL l, ItR s, ItR t,
+						 Cmp cmp)
+    -> decltype(std::invoke(cmp, *f, *s)) {
+	using ordering = decltype(std::invoke(cmp, *f, *s));
+	constexpr bool fast = std::is_same_v<Cmp, std::compare_three_way>;
+	if constexpr (fast && simd::comparable<ItL, ItR>) {
+		if (!std::is_constant_evaluated()) {
+			auto p = simd::ptr(f);
+			auto q = simd::ptr(s);
+			const size_t n = std::min(l - f, t - s);
+			if constexpr (simd::byte<std::iter_value_t<ItL>>) {
+				const int ret = (n != 0) ? memcmp(p, q, n) : 0;
+				if (ret != 0) return ret <=> 0;
+			} else {
+				const size_t i = simd::mismatch(p, q, n);
+				if (i != n) return p[i] <=> q[i];
+			}
+			return (l - f) <=> (t - s);
+		}
+	}
+	ordering ret = std::strong_ordering::equal;
+	auto br2 = [&ret, cmp](auto lhs, auto rhs) {
+		ret = std::invoke(cmp, lhs, rhs);
+		return ret == 0;
+	};
+	auto rng = loop::parallel_while(f, l, s, t, br2);
+	if (rng.found()) return ret;
+	if (rng.it.first != l) return std::strong_ordering::greater;
+	if (rng.it.second != t) return std::strong_ordering::less;
+	return std::strong_ordering::equal;
+}
+
+template <typename ItL, typename ItR>
+constexpr auto lexicographical_compare_three_way(ItL f, ItL l, ItR s,
+						 ItR t) {
+	return loop::lexicographical_compare_three_way(f, l, s, t,
+						       std::compare_three_way{});
+}
+
+template <typename ItL, typename ItR, typename If2>
+constexpr bool lexicographical_compare(ItL f, ItL l, ItR s, ItR t, If2 if2) {
+	using T = std::iter_value_t<ItL>;
+	constexpr bool fast = std::is_same_v<If2, std::less<>> ||
+			      std::is_same_v<If2, std::less<T>>;
+	if constexpr (fast && simd::comparable<ItL, ItR>) {
+		if (!std::is_constant_evaluated())
+			return loop::lexicographical_compare_three_way(f, l,
+								       s, t) < 0;
+	}
+	bool ret = false;
+	auto br2 = [&ret, if2](auto lhs, auto rhs) {
+		if (fn::bit(if2, lhs, rhs)) return !(ret = true);
+		return !fn::bit(if2, rhs, lhs);
+	};
+	auto rng = loop::parallel_while(f, l, s, t, br2);
+	if (rng.found()) return ret;
+	return (rng.it.first == l) && (rng.it.second != t);
+}
+
+template <typename ItL, typename ItR>
+constexpr bool lexicographical_compare(ItL f, ItL l, ItR s, ItR t) {
+	return loop::lexicographical_compare(f, l, s, t, std::less{});
 }
 
 // Partition
@@ -264,16 +851,325 @@ constexpr It partition_point(It f, It l, If1 if1) {
 	return loop::binary_find(f, l, if1);
 }
 
+// Heap
+
+template <typename It, typename If2>
+constexpr void sift_down(It f, ptrdiff_t n, ptrdiff_t i, If2 if2) {
+	auto val = std::move(f[i]);
+	for (ptrdiff_t c = 2 * i + 1; c < n; i = c, c = 2 * i + 1) {
+		if (c + 1 < n && fn::bit(if2, f[c], f[c + 1])) ++c;
+		if (!fn::bit(if2, val, f[c])) break;
+		f[i] = std::move(f[c]);
+	}
+	f[i] = std::move(val);
+}
+
+template <typename It, typename If2>
+constexpr void sift_up(It f, ptrdiff_t i, If2 if2) {
+	auto val = std::move(f[i]);
+	for (ptrdiff_t p = (i - 1) / 2; i > 0; i = p, p = (i - 1) / 2) {
+		if (!fn::bit(if2, f[p], val)) break;
+		f[i] = std::move(f[p]);
+	}
+	f[i] = std::move(val);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr It is_heap_until(It f, It l, If2 if2 = {}) {
+	if (f == l) return l;
+	auto br1 = [f, if2](auto it) {
+		return !fn::bit(if2, f[(it - f - 1) / 2], *it);
+	};
+	return loop::iterator_while(std::next(f), l, br1).it;
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr bool is_heap(It f, It l, If2 if2 = {}) {
+	return loop::is_heap_until(f, l, if2) == l;
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void make_heap(It f, It l, If2 if2 = {}) {
+	const auto n = l - f;
+	for (auto i = n / 2; i-- != 0;) loop::sift_down(f, n, i, if2);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void push_heap(It f, It l, If2 if2 = {}) {
+	if (l - f > 1) loop::sift_up(f, l - f - 1, if2);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void pop_heap(It f, It l, If2 if2 = {}) {
+	if (l - f < 2) return;
+	loop::iter_swap(f, --l);
+	loop::sift_down(f, l - f, 0, if2);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void sort_heap(It f, It l, If2 if2 = {}) {
+	for (; l - f > 1; --l) loop::pop_heap(f, l, if2);
+}
+
 // Sorts
 
-template <typename It>
-constexpr It is_sorted_until(It f, It l) {
-	return loop::adjacent_while(f, l, fn::ifnot(std::greater{})).it.second;
+template <typename It, typename If2 = std::less<>>
+constexpr It is_sorted_until(It f, It l, If2 if2 = {}) {
+	It it = loop::adjacent_find(f, l, fn::flip(if2));
+	return (it == l) ? l : std::next(it);
 }
 
-template <typename It>
-constexpr bool is_sorted(It f, It l) {
-	return loop::adjacent_while(f, l, fn::ifnot(std::greater{})).ended();
+template <typename It, typename If2 = std::less<>>
+constexpr bool is_sorted(It f, It l, If2 if2 = {}) {
+	return loop::is_sorted_until(f, l, if2) == l;
+}
+
+template <typename It, typename If2>
+constexpr void median_to_first(It r, It a, It b, It c, If2 if2) {
+	if (fn::bit(if2, *a, *b)) {
+		if (fn::bit(if2, *b, *c))
+			loop::iter_swap(r, b);
+		else if (fn::bit(if2, *a, *c))
+			loop::iter_swap(r, c);
+		else
+			loop::iter_swap(r, a);
+	} else if (fn::bit(if2, *a, *c)) {
+		loop::iter_swap(r, a);
+	} else if (fn::bit(if2, *b, *c)) {
+		loop::iter_swap(r, c);
+	} else {
+		loop::iter_swap(r, b);
+	}
+}
+
+// Needs l - f >= 4: the three samples must be distinct, and the largest
+// and smallest of them guard the unguarded scans
+template <typename It, typename If2>
+constexpr It partition_pivot(It f, It l, If2 if2) {
+	loop::median_to_first(f, f + 1, fn::midpoint(f, l), l - 1, if2);
+	It p = f;
+	for (++f;; ++f) {
+		while (fn::bit(if2, *f, *p)) ++f;
+		--l;
+		while (fn::bit(if2, *p, *l)) --l;
+		if (!(f < l)) return f;
+		loop::iter_swap(f, l);
+	}
+}
+
+template <size_t Cutoff, typename It, typename If2>
+constexpr void introsort(It f, It l, If2 if2, size_t depth) {
+	static_assert(Cutoff >= 3, "partition_pivot needs four elements");
+	while (static_cast<size_t>(l - f) > Cutoff) {
+		if (depth-- == 0) {
+			loop::make_heap(f, l, if2);
+			return loop::sort_heap(f, l, if2);
+		}
+		It m = loop::partition_pivot(f, l, if2);
+		if (m - f < l - m) {
+			loop::introsort<Cutoff>(f, m, if2, depth);
+			f = m;
+		} else {
+			loop::introsort<Cutoff>(m, l, if2, depth);
+			l = m;
+		}
+	}
+	network::sort_n<Cutoff>(f, l - f, if2);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void sort(It f, It l, If2 if2 = {}) {
+	const size_t n = l - f;
+	loop::introsort<tuning::sort_cutoff>(f, l, if2,
+					     2 * std::bit_width(n));
+}
+
+template <typename T, size_t N, typename If2 = std::less<>>
+constexpr void sort(std::array<T, N> & arr, If2 if2 = {}) {
+	if constexpr (N <= network::max)
+		network::sort<N>(arr.begin(), if2);
+	else
+		loop::sort(arr.begin(), arr.end(), if2);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void partial_sort(It f, It m, It l, If2 if2 = {}) {
+	if (f == m) return;
+	loop::make_heap(f, m, if2);
+	loop::iterator_each(m, l, [f, k = m - f, if2](It it) {
+		if (!fn::bit(if2, *it, *f)) return;
+		loop::iter_swap(it, f);
+		loop::sift_down(f, k, 0, if2);
+	});
+	loop::sort_heap(f, m, if2);
+}
+
+template <typename It, typename If2 = std::less<>>
+constexpr void nth_element(It f, It nth, It l, If2 if2 = {}) {
+	if (nth == l) return;
+	constexpr size_t cutoff = tuning::sort_cutoff;
+	for (size_t depth = 2 * std::bit_width(size_t(l - f));
+	     static_cast<size_t>(l - f) > cutoff;) {
+		if (depth-- == 0) return loop::partial_sort(f, nth + 1, l, if2);
+		It m = loop::partition_pivot(f, l, if2);
+		(nth < m) ? (l = m) : (f = m);
+	}
+	network::sort_n<cutoff>(f, l - f, if2);
+}
+
+// Selection
+
+// Streams [f, l) once through a bounded max-heap in `out`; the heap top is
+// the rejection threshold, so most elements cost a single comparison
+template <typename It, typename St, typename OutIt, typename If2>
+constexpr OutIt top_k_heap(It f, St l, size_t k, OutIt out, If2 if2) {
+	if (k == 0) return out;
+	size_t n = 0;
+	auto fill = fn::guard([&n, k](auto) { return (n == k); },
+			      [&n, out](auto elt) { out[n++] = elt; });
+	auto [it, ret] = loop::element_while(f, l, fill);
+	if (ret == tag::exhaust) {
+		loop::sort(out, out + n, if2);
+		return out + n;
+	}
+	const auto m = static_cast<ptrdiff_t>(k);
+	loop::make_heap(out, out + m, if2);
+	loop::element_while(it, l, [out, m, if2](auto elt) {
+		if (fn::bit(if2, elt, *out)) {
+			*out = elt;
+			loop::sift_down(out, m, 0, if2);
+		}
+		return true;
+	});
+	loop::sort_heap(out, out + m, if2);
+	return out + m;
+}
+
+// Buffers up to 2k candidates and cuts them back to k with nth_element;
+// the k-th element is the rejection threshold between cuts
+template <typename It, typename St, typename OutIt, typename If2>
+OutIt top_k_batch(It f, St l, size_t k, OutIt out, If2 if2) {
+	using T = typename std::iterator_traits<It>::value_type;
+	if (k == 0) return out;
+	std::vector<T> buf{};
+	buf.reserve(2 * k);
+	auto cut = [&buf, k, if2]() {
+		loop::nth_element(buf.begin(), buf.begin() + (k - 1), buf.end(),
+				  if2);
+		buf.erase(buf.begin() + k, buf.end());
+	};
+	bool full = false;
+	loop::element_while(f, l, [&buf, &full, &cut, k, if2](auto elt) {
+		if (full && !fn::bit(if2, elt, buf[k - 1])) return true;
+		buf.push_back(elt);
+		if (buf.size() == 2 * k) cut(), full = true;
+		return true;
+	});
+	if (buf.size() > k) cut();
+	loop::sort(buf.begin(), buf.end(), if2);
+	return loop::copy(buf.begin(), buf.end(), out);
+}
+
+constexpr size_t top_k_batch_min = 1 << 10;
+
+// The k first elements of [f, l) in `if2` order, written sorted to `out`;
+// single pass, so `l` may be any sentinel of an input iterator
+template <typename It, typename St, typename OutIt, typename If2 = std::less<>>
+OutIt top_k(It f, St l, size_t k, OutIt out, If2 if2 = {}) {
+	if (k < top_k_batch_min) return loop::top_k_heap(f, l, k, out, if2);
+	return loop::top_k_batch(f, l, k, out, if2);
+}
+
+template <typename It, typename OutIt, typename If2 = std::less<>>
+OutIt partial_sort_copy(It f, It l, OutIt rf, OutIt rl, If2 if2 = {}) {
+	return loop::top_k_heap(f, l, rl - rf, rf, if2);
+}
+
+// Merge
+
+template <typename It1, typename It2, typename OutIt,
+	  typename If2 = std::less<>>
+constexpr OutIt merge(It1 f1, It1 l1, It2 f2, It2 l2, OutIt out,
+		      If2 if2 = {}) {
+	for (; f1 != l1 && f2 != l2; ++out) {
+		if (fn::bit(if2, *f2, *f1))
+			*out = *f2, ++f2;
+		else
+			*out = *f1, ++f1;
+	}
+	return loop::copy(f2, l2, loop::copy(f1, l1, out));
+}
+
+// Merge path: how many of the first `d` merged elements come from the
+// first range, ties going to the first range
+template <typename It1, typename It2, typename If2>
+constexpr size_t co_rank(size_t d, It1 f1, size_t n1, It2 f2, size_t n2,
+			 If2 if2) {
+	const size_t lo = (d > n2) ? d - n2 : 0;
+	auto r = std::views::iota(lo, std::min(d, n1));
+	auto if1 = [d, f1, f2, if2](size_t i) {
+		return !fn::bit(if2, f2[d - 1 - i], f1[i]);
+	};
+	return lo + (loop::binary_find(r.begin(), r.end(), if1) - r.begin());
+}
+
+// Each thread merges an equal share of the output, its inputs found by
+// co-ranking both ends of the share
+template <typename It1, typename It2, typename OutIt,
+	  typename If2 = std::less<>>
+OutIt merge(parallel_policy policy, It1 f1, It1 l1, It2 f2, It2 l2, OutIt out,
+	    If2 if2 = {}) {
+	const size_t n1 = l1 - f1, n2 = l2 - f2, n = n1 + n2;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1) return loop::merge(f1, l1, f2, l2, out, if2);
+	parallel::invoke(k, [=](size_t t) {
+		const size_t d = parallel::split(n, k, t);
+		const size_t e = parallel::split(n, k, t + 1);
+		const size_t i = loop::co_rank(d, f1, n1, f2, n2, if2);
+		const size_t j = loop::co_rank(e, f1, n1, f2, n2, if2);
+		loop::merge(f1 + i, f1 + j, f2 + (d - i), f2 + (e - j), out + d,
+			    if2);
+	});
+	return out + n;
+}
+
+// Parallel merge sort: k runs sorted in parallel, then ceil(log2(k)) rounds
+// of pairwise merges that each keep all k threads busy through merge path
+template <typename It, typename If2 = std::less<>>
+void sort(parallel_policy policy, It f, It l, If2 if2 = {}) {
+	const size_t n = l - f;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1) return loop::sort(f, l, if2);
+	using T = std::iter_value_t<It>;
+	if constexpr (!std::contiguous_iterator<It>) {
+		std::vector<T> tmp(f, l);
+		loop::sort(policy, tmp.data(), tmp.data() + n, if2);
+		loop::copy(tmp.begin(), tmp.end(), f);
+	} else {
+		parallel::invoke(k, [=](size_t i) {
+			loop::sort(f + parallel::split(n, k, i),
+				   f + parallel::split(n, k, i + 1), if2);
+		});
+
+		// Each pair of runs gets threads in proportion to its length;
+		// a run left over is copied across
+		std::vector<T> buf(n);
+		T * src = std::to_address(f);
+		T * dst = buf.data();
+		auto fn4 = [&](size_t, size_t a, size_t b, size_t c) {
+			const size_t t = std::max<size_t>(1, k * (c - a) / n);
+			loop::merge(parallel_policy{t}, src + a, src + b,
+				    src + b, src + c, dst + a, if2);
+		};
+		parallel::rounds(n, k, fn4, [&] { std::swap(src, dst); });
+		if (src != std::to_address(f)) {
+			parallel::invoke(k, [=](size_t i) {
+				const size_t a = parallel::split(n, k, i);
+				const size_t b = parallel::split(n, k, i + 1);
+				loop::copy(src + a, src + b, dst + a);
+			});
+		}
+	}
 }
 
 // Binary Search
@@ -306,6 +1202,38 @@ constexpr range<It> equal_range(It f, It l, T val) {
 	}
 }
 
+template <typename It, typename T>
+constexpr It lower_bound(interpolation_search, It f, It l, T val) {
+	return loop::interpolation_find(f, l, val, fn::lt(val));
+}
+
+template <typename It, typename T>
+constexpr It upper_bound(interpolation_search, It f, It l, T val) {
+	return loop::interpolation_find(f, l, val, fn::ifnot(fn::gt(val)));
+}
+
+template <typename It, typename T>
+constexpr bool binary_search(interpolation_search, It f, It l, T val) {
+	It it = loop::lower_bound(interpolation, f, l, val);
+	return (it != l) && !(val < *it);
+}
+
+template <typename It, typename St, typename T>
+constexpr It lower_bound(exponential_search, It f, St l, T val) {
+	return loop::exponential_find(f, l, fn::lt(val));
+}
+
+template <typename It, typename St, typename T>
+constexpr It upper_bound(exponential_search, It f, St l, T val) {
+	return loop::exponential_find(f, l, fn::ifnot(fn::gt(val)));
+}
+
+template <typename It, typename St, typename T>
+constexpr bool binary_search(exponential_search, It f, St l, T val) {
+	It it = loop::lower_bound(exponential, f, l, val);
+	return !loop::done(it, l) && !(val < *it);
+}
+
 } // namespace loop
 
 #endif // !LOOP_STL_ALGORITHM_HPP
@@ -0,0 +1,264 @@
+#ifndef LOOP_STL_EXTERNAL_HPP
+#define LOOP_STL_EXTERNAL_HPP
+
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <memory>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "algorithm.hpp"
+#include "fn.hpp"
+
+namespace loop {
+
+namespace external {
+
+/* -----------------------
+ * Out-of-core ranges
+ *
+ * - mapped<T>: a file of fixed-size records as a contiguous range
+ * - sort     : sorts memory-sized runs, spills them back to back to a
+ *              temporary file and merges them with a loser tree
+ * ----------------------
+ */
+
+inline void fail(const char * what) {
+	throw std::system_error(errno, std::generic_category(), what);
+}
+
+template <typename T>
+class mapped {
+	static_assert(std::is_trivially_copyable_v<T>);
+
+	T * data = nullptr;
+	size_t n = 0;
+
+	void map(int fd, int prot, const char * path) {
+		if (n != 0) {
+			void * p = mmap(nullptr, n * sizeof(T), prot, MAP_SHARED,
+					fd, 0);
+			if (p == MAP_FAILED) close(fd), external::fail(path);
+			data = static_cast<T *>(p);
+			advise(MADV_SEQUENTIAL);
+		}
+		close(fd);
+	}
+
+      public:
+	// Maps an existing file read-only
+	explicit mapped(const char * path) {
+		int fd = open(path, O_RDONLY);
+		if (fd < 0) external::fail(path);
+		struct stat st {};
+		if (fstat(fd, &st) != 0) close(fd), external::fail(path);
+		n = st.st_size / sizeof(T);
+		map(fd, PROT_READ, path);
+	}
+
+	// Creates (or truncates) a file of `n` records, mapped read-write
+	mapped(const char * path, size_t n) : n(n) {
+		int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) external::fail(path);
+		if (ftruncate(fd, n * sizeof(T)) != 0)
+			close(fd), external::fail(path);
+		map(fd, PROT_READ | PROT_WRITE, path);
+	}
+
+	mapped(mapped && o) : data(o.data), n(o.n) { o.data = nullptr; }
+	mapped & operator=(mapped && o) {
+		std::swap(data, o.data);
+		std::swap(n, o.n);
+		return *this;
+	}
+	~mapped() {
+		if (data) munmap(data, n * sizeof(T));
+	}
+
+	void advise(int advice) const {
+		if (data) madvise(data, n * sizeof(T), advice);
+	}
+
+	T * begin() const { return data; }
+	T * end() const { return data + n; }
+	size_t size() const { return n; }
+};
+
+// Reads records [first, last) of a spill file a block at a time
+template <typename T>
+class run {
+	int fd;
+	size_t at, last;
+	std::vector<T> buf;
+	size_t pos = 0, len = 0;
+
+      public:
+	run(int fd, size_t first, size_t last, size_t block)
+	    : fd(fd), at(first), last(last), buf(block) {
+		fill();
+	}
+
+	void fill() {
+		pos = 0;
+		len = std::min(buf.size(), last - at);
+		char * p = reinterpret_cast<char *>(buf.data());
+		size_t done = 0;
+		while (done != len * sizeof(T)) {
+			const ssize_t r = pread(fd, p + done,
+						len * sizeof(T) - done,
+						at * sizeof(T) + done);
+			if (r <= 0) external::fail("pread");
+			done += r;
+		}
+		at += len;
+	}
+
+	const T * head() const { return (pos < len) ? &buf[pos] : nullptr; }
+
+	void next() {
+		if (++pos == len) fill();
+	}
+};
+
+template <typename T, typename If2>
+class loser_tree {
+	std::vector<run<T>> & runs;
+	std::vector<size_t> tree;
+	If2 if2;
+
+	bool beats(size_t a, size_t b) const {
+		const T * x = runs[a].head();
+		const T * y = runs[b].head();
+		if (!y) return true;
+		if (!x) return false;
+		return !fn::bit(if2, *y, *x);
+	}
+
+      public:
+	loser_tree(std::vector<run<T>> & runs, If2 if2)
+	    : runs(runs), tree(runs.size()), if2(if2) {
+		const size_t k = runs.size();
+		std::vector<size_t> win(2 * k);
+		for (size_t i = 0; i < k; ++i) win[k + i] = i;
+		for (size_t i = k; i-- > 1;) {
+			const size_t a = win[2 * i], b = win[2 * i + 1];
+			win[i] = beats(a, b) ? a : b;
+			tree[i] = beats(a, b) ? b : a;
+		}
+		tree[0] = win[1];
+	}
+
+	const T * top() const { return runs[tree[0]].head(); }
+
+	void pop() {
+		size_t s = tree[0];
+		runs[s].next();
+		for (size_t i = (s + runs.size()) / 2; i > 0; i /= 2)
+			if (beats(tree[i], s)) std::swap(tree[i], s);
+		tree[0] = s;
+	}
+};
+
+// Closes on scope exit, so a sort that throws part way leaks no handles
+using file = std::unique_ptr<FILE, int (*)(FILE *)>;
+
+// Sorted runs stored back to back in one file, run i at records
+// [bounds[i], bounds[i + 1]), so any number of runs holds one descriptor
+struct spill {
+	file f;
+	std::vector<size_t> bounds{0};
+
+	size_t runs() const { return bounds.size() - 1; }
+};
+
+// Merges runs [i, j) of `in` onto the end of `out`
+template <typename T, typename If2>
+void merge(const spill & in, size_t i, size_t j, FILE * out, size_t budget,
+	   If2 if2) {
+	if (i == j) return;
+	const size_t block = std::max<size_t>(1, budget / (j - i + 1));
+	const int fd = fileno(in.f.get());
+	std::vector<run<T>> runs{};
+	runs.reserve(j - i);
+	for (size_t r = i; r < j; ++r)
+		runs.emplace_back(fd, in.bounds[r], in.bounds[r + 1], block);
+
+	std::vector<T> buf{};
+	buf.reserve(block);
+	auto flush = [&buf, out]() {
+		const size_t n = buf.size();
+		if (fwrite(buf.data(), sizeof(T), n, out) != n)
+			external::fail("fwrite");
+		buf.clear();
+	};
+	for (loser_tree<T, If2> lt{runs, if2}; lt.top(); lt.pop()) {
+		buf.push_back(*lt.top());
+		if (buf.size() == block) flush();
+	}
+	flush();
+}
+
+inline file stream(const char * path, const char * mode) {
+	file f{fopen(path, mode), fclose};
+	if (!f) external::fail(path);
+	return f;
+}
+
+inline file temporary() {
+	file f{tmpfile(), fclose};
+	if (!f) external::fail("tmpfile");
+	setvbuf(f.get(), nullptr, _IONBF, 0);
+	return f;
+}
+
+// Sorts the records of `in` into `out` using about `memory` bytes
+template <typename T, typename If2 = std::less<>>
+void sort(const char * in, const char * out, size_t memory, If2 if2 = {}) {
+	static_assert(std::is_trivially_copyable_v<T>);
+	constexpr size_t page = 1 << 12;
+	const size_t budget = std::max<size_t>(1, memory / sizeof(T));
+	const size_t fan = std::max<size_t>(3, memory / page) - 1;
+
+	spill runs{external::temporary()};
+	{
+		file src = external::stream(in, "rb");
+		std::vector<T> buf(budget);
+		size_t n = 0;
+		while ((n = fread(buf.data(), sizeof(T), budget, src.get())) !=
+		       0) {
+			loop::sort(buf.begin(), buf.begin() + n, if2);
+			if (fwrite(buf.data(), sizeof(T), n, runs.f.get()) != n)
+				external::fail("fwrite");
+			runs.bounds.push_back(runs.bounds.back() + n);
+		}
+	}
+
+	while (runs.runs() > fan) {
+		spill next{external::temporary()};
+		for (size_t i = 0; i < runs.runs(); i += fan) {
+			const size_t j = std::min(i + fan, runs.runs());
+			external::merge<T>(runs, i, j, next.f.get(), budget,
+					   if2);
+			next.bounds.push_back(runs.bounds[j]);
+		}
+		runs = std::move(next);
+	}
+
+	file dst = external::stream(out, "wb");
+	setvbuf(dst.get(), nullptr, _IONBF, 0);
+	external::merge<T>(runs, 0, runs.runs(), dst.get(), budget, if2);
+	if (fclose(dst.release()) != 0) external::fail(out);
+}
+
+} // namespace external
+} // namespace loop
+
+#endif // !LOOP_STL_EXTERNAL_HPP
@@ -22,6 +22,8 @@ namespace fn {
  *
  * - Wr1 : Unary writer
  * - Wr2 : Binary writer
+ *
+ * - Lp2 : Loop over a (first, last) pair
  * ----------------------
  */
 
@@ -69,7 +71,7 @@ constexpr auto before(Fn2 fn2, Fn1 fn1) {
 template <typename T>
 struct constant {
 	T val;
-	constant(T val) : val(val) {}
+	constexpr constant(T val) : val(val) {}
 
 	template <typename U>
 	constexpr bool operator()(U) const {
@@ -93,7 +95,7 @@ constexpr bool bit(If if_, Ts... elt) {
 template <typename If>
 struct ifnot {
 	If if_;
-	ifnot(If if_) : if_(if_) {}
+	constexpr ifnot(If if_) : if_(if_) {}
 
 	template <typename... Ts>
 	constexpr bool operator()(Ts... elt) const {
@@ -101,11 +103,41 @@ struct ifnot {
 	}
 };
 
+template <typename Fn2>
+struct flip {
+	Fn2 fn2;
+	constexpr flip(Fn2 fn2) : fn2(fn2) {}
+
+	template <typename T, typename U>
+	constexpr auto operator()(T lhs, U rhs) const {
+		return std::invoke(fn2, rhs, lhs);
+	}
+};
+
+// Standard comparisons, which kernels may call more often than an
+// algorithm specifies since no caller can observe the calls
+template <typename If2>
+constexpr bool pure = false;
+template <typename T>
+constexpr bool pure<std::equal_to<T>> = true;
+template <typename T>
+constexpr bool pure<std::not_equal_to<T>> = true;
+template <typename T>
+constexpr bool pure<std::less<T>> = true;
+template <typename T>
+constexpr bool pure<std::greater<T>> = true;
+template <typename T>
+constexpr bool pure<std::less_equal<T>> = true;
+template <typename T>
+constexpr bool pure<std::greater_equal<T>> = true;
+template <typename If2>
+constexpr bool pure<flip<If2>> = pure<If2>;
+
 template <typename If1, typename Fn1>
 struct guard {
 	If1 if1;
 	Fn1 fn1;
-	guard(If1 if1, Fn1 fn1) : if1(if1), fn1(fn1) {}
+	constexpr guard(If1 if1, Fn1 fn1) : if1(if1), fn1(fn1) {}
 
 	template <typename T>
 	constexpr bool operator()(T elt) const {
@@ -121,21 +153,21 @@ struct guard {
 template <typename T>
 struct eq {
 	T val;
-	eq(T val) : val(val) {}
+	constexpr eq(T val) : val(val) {}
 	constexpr bool operator()(T elt) const { return elt == val; }
 };
 
 template <typename T>
 struct lt {
 	T val;
-	lt(T val) : val(val) {}
+	constexpr lt(T val) : val(val) {}
 	constexpr bool operator()(T elt) const { return elt < val; }
 };
 
 template <typename T>
 struct gt {
 	T val;
-	gt(T val) : val(val) {}
+	constexpr gt(T val) : val(val) {}
 	constexpr bool operator()(T elt) const { return val < elt; }
 };
 
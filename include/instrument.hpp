@@ -0,0 +1,173 @@
+#ifndef LOOP_STL_INSTRUMENT_HPP
+#define LOOP_STL_INSTRUMENT_HPP
+
+#include <compare>
+#include <functional>
+#include <iterator>
+#include <stdlib.h>
+#include <utility>
+
+namespace loop {
+
+namespace instrument {
+
+/* -----------------------
+ * Operation counting
+ *
+ * - value<T>    : counts comparisons, copies and moves
+ * - iterator<It>: counts increments, jumps and dereferences
+ * - function<F> : counts invocations
+ *
+ * Every wrapper carries a pointer to the `counters` it reports to.
+ * ----------------------
+ */
+
+struct counters {
+	size_t compares = 0;
+	size_t calls = 0;
+	size_t increments = 0;
+	size_t jumps = 0;
+	size_t derefs = 0;
+	size_t copies = 0;
+	size_t moves = 0;
+
+	constexpr void reset() { *this = counters{}; }
+};
+
+constexpr void tally(counters * c, size_t counters::*field) {
+	if (c) ++(c->*field);
+}
+
+template <typename T>
+struct value {
+	T val{};
+	counters * c = nullptr;
+
+	constexpr value() = default;
+	constexpr value(T val, counters * c) : val(val), c(c) {}
+
+	constexpr value(const value & o) : val(o.val), c(o.c) {
+		instrument::tally(c, &counters::copies);
+	}
+	constexpr value(value && o) : val(std::move(o.val)), c(o.c) {
+		instrument::tally(c, &counters::moves);
+	}
+	constexpr value & operator=(const value & o) {
+		val = o.val, c = o.c;
+		instrument::tally(c, &counters::copies);
+		return *this;
+	}
+	constexpr value & operator=(value && o) {
+		val = std::move(o.val), c = o.c;
+		instrument::tally(c, &counters::moves);
+		return *this;
+	}
+
+	constexpr friend bool operator==(const value & lhs, const value & rhs) {
+		instrument::tally(lhs.c, &counters::compares);
+		return lhs.val == rhs.val;
+	}
+	constexpr friend auto operator<=>(const value & lhs, const value & rhs) {
+		instrument::tally(lhs.c, &counters::compares);
+		return lhs.val <=> rhs.val;
+	}
+};
+
+template <typename It>
+struct iterator {
+	using traits = std::iterator_traits<It>;
+	using iterator_category = typename traits::iterator_category;
+	using value_type = typename traits::value_type;
+	using difference_type = typename traits::difference_type;
+	using reference = typename traits::reference;
+	using pointer = typename traits::pointer;
+
+	It it{};
+	counters * c = nullptr;
+
+	constexpr iterator() = default;
+	constexpr iterator(It it, counters * c) : it(it), c(c) {}
+
+	constexpr reference operator*() const {
+		instrument::tally(c, &counters::derefs);
+		return *it;
+	}
+	constexpr pointer operator->() const {
+		instrument::tally(c, &counters::derefs);
+		return std::to_address(it);
+	}
+	constexpr reference operator[](difference_type n) const {
+		instrument::tally(c, &counters::derefs);
+		return it[n];
+	}
+
+	constexpr iterator & operator++() {
+		instrument::tally(c, &counters::increments);
+		return ++it, *this;
+	}
+	constexpr iterator operator++(int) {
+		auto ret = *this;
+		return ++*this, ret;
+	}
+	constexpr iterator & operator--() {
+		instrument::tally(c, &counters::increments);
+		return --it, *this;
+	}
+	constexpr iterator operator--(int) {
+		auto ret = *this;
+		return --*this, ret;
+	}
+
+	constexpr iterator & operator+=(difference_type n) {
+		instrument::tally(c, &counters::jumps);
+		return it += n, *this;
+	}
+	constexpr iterator & operator-=(difference_type n) {
+		return *this += -n;
+	}
+	constexpr friend iterator operator+(iterator lhs, difference_type n) {
+		return lhs += n;
+	}
+	constexpr friend iterator operator+(difference_type n, iterator rhs) {
+		return rhs += n;
+	}
+	constexpr friend iterator operator-(iterator lhs, difference_type n) {
+		return lhs -= n;
+	}
+	constexpr friend difference_type operator-(const iterator & lhs,
+						   const iterator & rhs) {
+		return lhs.it - rhs.it;
+	}
+
+	constexpr friend bool operator==(const iterator & lhs,
+					 const iterator & rhs) {
+		return lhs.it == rhs.it;
+	}
+	constexpr friend auto operator<=>(const iterator & lhs,
+					  const iterator & rhs) {
+		return lhs.it <=> rhs.it;
+	}
+};
+
+template <typename F>
+struct function {
+	F f;
+	counters * c = nullptr;
+
+	template <typename... Ts>
+	constexpr decltype(auto) operator()(Ts &&... elt) const {
+		instrument::tally(c, &counters::calls);
+		return std::invoke(f, std::forward<Ts>(elt)...);
+	}
+};
+
+template <typename It>
+constexpr auto wrap(It f, It l, counters * c) {
+	return std::pair{instrument::iterator{f, c},
+			 instrument::iterator{l, c}};
+}
+
+} // namespace instrument
+} // namespace loop
+
+#endif // !LOOP_STL_INSTRUMENT_HPP
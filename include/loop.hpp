@@ -1,11 +1,17 @@
 #ifndef LOOP_STL_LOOP_HPP
 #define LOOP_STL_LOOP_HPP
 
+#include <algorithm>
+#include <bit>
 #include <functional>
+#include <iterator>
 #include <optional>
 #include <stdint.h>
+#include <type_traits>
 
 #include "fn.hpp"
+#include "segmented.hpp"
+#include "tuning.hpp"
 
 namespace loop {
 
@@ -14,8 +20,8 @@ constexpr bool done(It, std::nullptr_t) {
 	return false;
 }
 
-template <typename It>
-constexpr bool done(It f, It l) {
+template <typename It, typename St>
+constexpr bool done(It f, St l) {
 	return f == l;
 }
 
@@ -92,14 +98,41 @@ constexpr It iterator_each(It f, It l, Fn1 fn1) {
 	return loop::iterator_while(f, l, fn::side_effect(fn1)).it;
 }
 
+template <typename It, typename St, typename Lp2>
+constexpr exited<It> segment_while(It f, St l, Lp2 lp2) {
+	if constexpr (!loop::segmented<It, St>) {
+		return std::invoke(lp2, f, l);
+	} else {
+		using traits = segmented_iterator_traits<It>;
+		auto s = traits::segment(f);
+		auto t = traits::segment(l);
+		for (auto lf = traits::local(f);; lf = traits::begin(++s)) {
+			auto ll = (s == t) ? traits::local(l) : traits::end(s);
+			auto [it, ret] = std::invoke(lp2, lf, ll);
+			if (s == t || ret == tag::condition)
+				return {traits::compose(s, it), ret};
+		}
+	}
+}
+
+template <typename It, typename Fn2>
+constexpr void segment_each(It f, It l, Fn2 fn2) {
+	loop::segment_while(f, l, [fn2](auto f, auto l) {
+		std::invoke(fn2, f, l);
+		return exited<decltype(l)>{l, tag::exhaust};
+	});
+}
+
 template <typename It, typename St, typename Br1>
 constexpr exited<It> element_while(It f, St l, Br1 br1) {
-	return loop::iterator_while(f, l, fn::deref(br1));
+	return loop::segment_while(f, l, [br1](auto f, auto l) {
+		return loop::iterator_while(f, l, fn::deref(br1));
+	});
 }
 
 template <typename It, typename Fn1>
 constexpr It element_each(It f, It l, Fn1 fn1) {
-	return loop::iterator_each(f, l, fn::deref(fn1));
+	return loop::element_while(f, l, fn::side_effect(fn1)).it;
 }
 
 template <typename InIt, typename OutIt>
@@ -159,10 +192,68 @@ constexpr exited<range<It>> binary_recurse(It f, It l, If1 if1, Br1 br1) {
 	return {{f, l}, tag::exhaust};
 }
 
-template <typename It, typename If1>
+// Ranges of at most `Linear` arithmetic keys are scanned instead of bisected,
+// costing up to `Linear` predicate calls over the log2(n) of bisection
+template <size_t Linear = tuning::linear_search, typename It, typename If1>
 constexpr It binary_find(It f, It l, If1 if1) {
-	auto [lb, ub] = loop::binary_recurse(f, l, if1, fn::constant(false)).it;
-	return fn::midpoint(lb, ub);
+	if constexpr (std::is_arithmetic_v<std::iter_value_t<It>>) {
+		while (static_cast<size_t>(l - f) > Linear) {
+			const auto mid = fn::midpoint(f, l);
+			if (fn::bit(if1, *mid))
+				f = mid + 1;
+			else
+				l = mid;
+		}
+		return loop::iterator_while(f, l, fn::deref(if1)).it;
+	} else {
+		auto [lb, ub] =
+		    loop::binary_recurse(f, l, if1, fn::constant(false)).it;
+		return fn::midpoint(lb, ub);
+	}
+}
+
+struct interpolation_search {};
+inline constexpr interpolation_search interpolation{};
+
+// Partition point of [f, l) probing where `val` would sit if the keys were
+// evenly spread; after O(log log n) probes without converging it falls back
+// to bisection, so the worst case stays O(log n)
+template <typename It, typename T, typename If1>
+constexpr It interpolation_find(It f, It l, T val, If1 if1) {
+	if (l - f < 2) return loop::binary_find(f, l, if1);
+	const double x = static_cast<double>(val);
+	It a = f, b = l - 1;
+	double lo = static_cast<double>(*a), hi = static_cast<double>(*b);
+	size_t budget = std::bit_width(std::bit_width(size_t(l - f))) + 2;
+	for (; l - f > 8 && budget != 0 && lo < hi; --budget) {
+		double t = (x - lo) / (hi - lo) * (b - a);
+		t = (t >= 0) ? t : 0;
+		It p = a + static_cast<ptrdiff_t>(std::min(t, double(b - a)));
+		p = std::clamp(p, f, l - 1);
+		const auto elt = *p;
+		if (fn::bit(if1, elt))
+			a = p, f = p + 1, lo = static_cast<double>(elt);
+		else
+			b = p, l = p, hi = static_cast<double>(elt);
+	}
+	return loop::binary_find(f, l, if1);
+}
+
+struct exponential_search {};
+inline constexpr exponential_search exponential{};
+
+// Partition point of [f, l) found from the front in O(log d) probes, with
+// d its distance from `f`; `l` may be nullptr for an unbounded range
+template <typename It, typename St, typename If1>
+constexpr It exponential_find(It f, St l, If1 if1) {
+	for (ptrdiff_t step = 1;; step *= 2) {
+		if constexpr (!std::is_same_v<St, std::nullptr_t>) {
+			if (l - f < step) return loop::binary_find(f, l, if1);
+		}
+		It p = f + (step - 1);
+		if (!fn::bit(if1, *p)) return loop::binary_find(f, p, if1);
+		f = p + 1;
+	}
 }
 
 } // namespace loop
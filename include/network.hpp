@@ -0,0 +1,141 @@
+#ifndef LOOP_STL_NETWORK_HPP
+#define LOOP_STL_NETWORK_HPP
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <stdint.h>
+#include <stdlib.h>
+#include <type_traits>
+#include <utility>
+
+#include "fn.hpp"
+
+namespace loop {
+
+namespace network {
+
+/* -----------------------
+ * Sorting networks
+ *
+ * Comparators are generated at compile time with the Bose-Nelson
+ * construction and applied as an unrolled sequence of compare-exchanges,
+ * branchless for arithmetic keys under less or greater.
+ * ----------------------
+ */
+
+constexpr size_t max = 32;
+
+struct comparator {
+	uint8_t i, j;
+};
+
+template <typename Fn2>
+constexpr void bracket(size_t i, size_t x, size_t j, size_t y, Fn2 & emit) {
+	if (x == 1 && y == 1) {
+		emit(i, j);
+	} else if (x == 1 && y == 2) {
+		emit(i, j + 1);
+		emit(i, j);
+	} else if (x == 2 && y == 1) {
+		emit(i, j);
+		emit(i + 1, j);
+	} else {
+		const size_t a = x / 2;
+		const size_t b = (x & 1) ? y / 2 : (y + 1) / 2;
+		network::bracket(i, a, j, b, emit);
+		network::bracket(i + a, x - a, j + b, y - b, emit);
+		network::bracket(i + a, x - a, j, b, emit);
+	}
+}
+
+template <typename Fn2>
+constexpr void bose_nelson(size_t i, size_t n, Fn2 & emit) {
+	if (n < 2) return;
+	const size_t a = n / 2;
+	network::bose_nelson(i, a, emit);
+	network::bose_nelson(i + a, n - a, emit);
+	network::bracket(i, a, i + a, n - a, emit);
+}
+
+template <size_t N>
+constexpr size_t size() {
+	size_t n = 0;
+	auto emit = [&n](size_t, size_t) { ++n; };
+	network::bose_nelson(0, N, emit);
+	return n;
+}
+
+template <size_t N>
+constexpr auto comparators = [] {
+	std::array<comparator, network::size<N>()> ret{};
+	size_t k = 0;
+	auto emit = [&ret, &k](size_t i, size_t j) {
+		ret[k++] = {static_cast<uint8_t>(i), static_cast<uint8_t>(j)};
+	};
+	network::bose_nelson(0, N, emit);
+	return ret;
+}();
+
+template <typename T, typename If2>
+constexpr bool ascending = std::is_arithmetic_v<T> &&
+			   (std::is_same_v<If2, std::less<>> ||
+			    std::is_same_v<If2, std::less<T>>);
+
+template <typename T, typename If2>
+constexpr bool descending = std::is_arithmetic_v<T> &&
+			    (std::is_same_v<If2, std::greater<>> ||
+			     std::is_same_v<If2, std::greater<T>>);
+
+// Arithmetic keys under less or greater are exchanged as a min and the
+// value left over. GCC turns a min/max pair, or a select on one compare,
+// back into a conditional swap; integers recover the max with xor, floats
+// with a max that lowers to vmaxsd, and neither then branches
+template <typename T>
+constexpr void minmax(T & lo, T & hi) {
+	const T x = lo, y = hi;
+	lo = std::min(x, y);
+	if constexpr (std::is_integral_v<T>)
+		hi = static_cast<T>(x ^ y ^ lo);
+	else
+		hi = std::max(x, y);
+}
+
+template <typename It, typename If2>
+constexpr void exchange(It a, It b, If2 if2) {
+	using T = std::iter_value_t<It>;
+	if constexpr (ascending<T, If2>) {
+		network::minmax<T>(*a, *b);
+	} else if constexpr (descending<T, If2>) {
+		network::minmax<T>(*b, *a);
+	} else {
+		auto x = std::move(*a);
+		auto y = std::move(*b);
+		const bool swap = fn::bit(if2, y, x);
+		*a = std::move(swap ? y : x);
+		*b = std::move(swap ? x : y);
+	}
+}
+
+template <size_t N, typename It, typename If2>
+constexpr void sort(It f, If2 if2) {
+	static_assert(N <= network::max, "no sorting network that large");
+	constexpr auto & cs = network::comparators<N>;
+	[&]<size_t... I>(std::index_sequence<I...>) {
+		(network::exchange(f + cs[I].i, f + cs[I].j, if2), ...);
+	}(std::make_index_sequence<cs.size()>{});
+}
+
+template <size_t M, typename It, typename If2>
+constexpr void sort_n(It f, size_t n, If2 if2) {
+	static_assert(M <= network::max, "no sorting network that large");
+	[&]<size_t... N>(std::index_sequence<N...>) {
+		(void) ((n == N && (network::sort<N>(f, if2), true)) || ...);
+	}(std::make_index_sequence<M + 1>{});
+}
+
+} // namespace network
+} // namespace loop
+
+#endif // !LOOP_STL_NETWORK_HPP
@@ -1,11 +1,16 @@
 #ifndef LOOP_STL_NUMERIC_HPP
 #define LOOP_STL_NUMERIC_HPP
 
+#include <iterator>
+#include <optional>
 #include <stdlib.h>
+#include <vector>
 
 #include "algorithm.hpp"
 #include "fn.hpp"
 #include "loop.hpp"
+#include "parallel.hpp"
+#include "simd.hpp"
 
 namespace loop {
 
@@ -43,13 +48,35 @@ constexpr T inner_product(ItL f, ItL l, ItR s, T init, Fn2R fn2_r, Fn2M fn2_m) {
 }
 
 template <typename InIt, typename OutIt, typename Fn2>
-constexpr OutIt adjancent_difference(InIt f, InIt l, OutIt out, Fn2 fn2) {
+constexpr OutIt adjacent_difference(InIt f, InIt l, OutIt out, Fn2 fn2) {
 	if (f == l) return out;
-	fn::writer(out)(*f);
-	auto wr2 = [fn2](auto writer, auto lhs, auto rhs) {
-		std::invoke(writer, std::invoke(fn2, rhs, lhs));
+	using T = std::iter_value_t<InIt>;
+	if constexpr (simd::contiguous<InIt> && std::is_arithmetic_v<T> &&
+		      std::is_same_v<std::invoke_result_t<Fn2, T, T>, T>) {
+		if (!std::is_constant_evaluated()) {
+			return simd::output<T>(out, [&](auto o) {
+				return simd::difference(simd::ptr(f), l - f, o,
+							fn2);
+			});
+		}
+	}
+	T prev = *f;
+	fn::writer(out)(prev);
+	auto wr1 = [&prev, fn2](auto writer, auto elt) {
+		std::invoke(writer, std::invoke(fn2, elt, prev));
+		prev = elt;
 	};
-	return loop::copy_adjacent(f, l, out, wr2);
+	return loop::copy_each(++f, l, out, wr1);
+}
+
+template <typename InIt, typename OutIt>
+constexpr OutIt adjacent_difference(InIt f, InIt l, OutIt out) {
+	return loop::adjacent_difference(f, l, out, std::minus{});
+}
+
+template <typename InIt, typename OutIt, typename Fn2>
+constexpr OutIt adjancent_difference(InIt f, InIt l, OutIt out, Fn2 fn2) {
+	return loop::adjacent_difference(f, l, out, fn2);
 }
 
 template <typename InIt, typename OutIt, typename T, typename Fn2>
@@ -93,6 +120,208 @@ constexpr OutIt transform_exclusive_scan(InIt f, InIt l, OutIt out, T init,
 	return loop::exclusive_scan(f, l, out, init, fn::before(fn2, fn1));
 }
 
+// By key
+
+template <typename KIt, typename VIt, typename KOut, typename VOut,
+	  typename If2, typename Fn2>
+constexpr std::pair<KOut, VOut> reduce_by_key(KIt f, KIt l, VIt v, KOut kout,
+					      VOut vout, If2 eq, Fn2 op) {
+	if (f == l) return {kout, vout};
+	auto key = *f;
+	auto acc = *v;
+	auto br2 = [&v, &key, &acc, eq, op, wk = fn::writer(kout),
+		    wv = fn::writer(vout)](auto lhs, auto rhs) {
+		++v;
+		if (fn::bit(eq, lhs, rhs)) {
+			acc = std::invoke(op, acc, *v);
+		} else {
+			wk(key), wv(acc);
+			key = rhs, acc = *v;
+		}
+		return true;
+	};
+	loop::adjacent_while(f, l, br2);
+	fn::writer(kout)(key);
+	fn::writer(vout)(acc);
+	return {kout, vout};
+}
+
+template <typename KIt, typename VIt, typename OutIt, typename T,
+	  typename If2, typename Fn2>
+constexpr OutIt inclusive_scan_by_key(KIt f, KIt l, VIt v, OutIt out,
+				      std::optional<T> carry, If2 eq, Fn2 op) {
+	if (f == l) return out;
+	T acc = carry ? std::invoke(op, *carry, *v) : *v;
+	auto w = fn::writer(out);
+	w(acc);
+	auto br2 = [&v, &acc, eq, op, w](auto lhs, auto rhs) {
+		++v;
+		if (fn::bit(eq, lhs, rhs))
+			acc = std::invoke(op, acc, *v);
+		else
+			acc = *v;
+		w(acc);
+		return true;
+	};
+	loop::adjacent_while(f, l, br2);
+	return out;
+}
+
+template <typename KIt, typename VIt, typename OutIt, typename If2,
+	  typename Fn2>
+constexpr OutIt inclusive_scan_by_key(KIt f, KIt l, VIt v, OutIt out, If2 eq,
+				      Fn2 op) {
+	using T = typename std::iterator_traits<VIt>::value_type;
+	return loop::inclusive_scan_by_key(f, l, v, out, std::optional<T>{},
+					   eq, op);
+}
+
+template <typename KIt, typename VIt, typename OutIt, typename T,
+	  typename If2, typename Fn2>
+constexpr OutIt exclusive_scan_by_key(KIt f, KIt l, VIt v, OutIt out, T carry,
+				      T init, If2 eq, Fn2 op) {
+	if (f == l) return out;
+	T acc = carry;
+	auto w = fn::writer(out);
+	w(acc);
+	acc = std::invoke(op, acc, *v);
+	auto br2 = [&v, &acc, init, eq, op, w](auto lhs, auto rhs) {
+		++v;
+		if (!fn::bit(eq, lhs, rhs)) acc = init;
+		w(acc);
+		acc = std::invoke(op, acc, *v);
+		return true;
+	};
+	loop::adjacent_while(f, l, br2);
+	return out;
+}
+
+template <typename KIt, typename VIt, typename OutIt, typename T,
+	  typename If2, typename Fn2>
+constexpr OutIt exclusive_scan_by_key(KIt f, KIt l, VIt v, OutIt out, T init,
+				      If2 eq, Fn2 op) {
+	return loop::exclusive_scan_by_key(f, l, v, out, init, init, eq, op);
+}
+
+// Reduction of the segment still open at the end of each chunk, carried
+// into the next chunk (empty when that chunk starts a new segment)
+template <typename KIt, typename VIt, typename If2, typename Fn2>
+auto carries_by_key(size_t k, KIt f, KIt l, VIt v, If2 eq, Fn2 op) {
+	using T = typename std::iterator_traits<VIt>::value_type;
+	const size_t n = l - f;
+	std::vector<std::optional<T>> tail(k), carry(k);
+	std::vector<char> open(k);
+	parallel::invoke(k, [&](size_t i) {
+		const size_t b = parallel::split(n, k, i);
+		const size_t e = parallel::split(n, k, i + 1);
+		size_t h = e - 1;
+		while (h != b && fn::bit(eq, f[h - 1], f[h])) --h;
+		open[i] = (h == b) && (b != 0) && fn::bit(eq, f[b - 1], f[b]);
+		T acc = v[h];
+		for (size_t j = h + 1; j != e; ++j)
+			acc = std::invoke(op, acc, v[j]);
+		tail[i] = acc;
+	});
+	for (size_t i = 1; i < k; ++i) {
+		const size_t b = parallel::split(n, k, i);
+		if (!fn::bit(eq, f[b - 1], f[b])) continue;
+		carry[i] = open[i - 1]
+			       ? std::invoke(op, *carry[i - 1], *tail[i - 1])
+			       : *tail[i - 1];
+	}
+	return carry;
+}
+
+template <typename KIt, typename VIt, typename OutIt, typename If2,
+	  typename Fn2>
+OutIt inclusive_scan_by_key(parallel_policy policy, KIt f, KIt l, VIt v,
+			    OutIt out, If2 eq, Fn2 op) {
+	const size_t n = l - f;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1) return loop::inclusive_scan_by_key(f, l, v, out, eq, op);
+	auto carry = loop::carries_by_key(k, f, l, v, eq, op);
+	parallel::invoke(k, [&](size_t i) {
+		const size_t b = parallel::split(n, k, i);
+		const size_t e = parallel::split(n, k, i + 1);
+		loop::inclusive_scan_by_key(f + b, f + e, v + b, out + b,
+					    carry[i], eq, op);
+	});
+	return out + n;
+}
+
+template <typename KIt, typename VIt, typename OutIt, typename T,
+	  typename If2, typename Fn2>
+OutIt exclusive_scan_by_key(parallel_policy policy, KIt f, KIt l, VIt v,
+			    OutIt out, T init, If2 eq, Fn2 op) {
+	const size_t n = l - f;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1)
+		return loop::exclusive_scan_by_key(f, l, v, out, init, eq, op);
+	auto carry = loop::carries_by_key(k, f, l, v, eq, op);
+	parallel::invoke(k, [&](size_t i) {
+		const size_t b = parallel::split(n, k, i);
+		const size_t e = parallel::split(n, k, i + 1);
+		const T acc =
+		    carry[i] ? T(std::invoke(op, init, *carry[i])) : init;
+		loop::exclusive_scan_by_key(f + b, f + e, v + b, out + b, acc,
+					    init, eq, op);
+	});
+	return out + n;
+}
+
+template <typename KIt, typename VIt, typename KOut, typename VOut,
+	  typename If2, typename Fn2>
+std::pair<KOut, VOut> reduce_by_key(parallel_policy policy, KIt f, KIt l,
+				    VIt v, KOut kout, VOut vout, If2 eq,
+				    Fn2 op) {
+	using T = typename std::iterator_traits<VIt>::value_type;
+	const size_t n = l - f;
+	const size_t k = parallel::chunks(policy, n);
+	if (k == 1) return loop::reduce_by_key(f, l, v, kout, vout, eq, op);
+
+	// Segment heads per chunk give each chunk its output offset
+	std::vector<size_t> offset(k + 1), lead(k);
+	parallel::invoke(k, [&](size_t i) {
+		const size_t b = parallel::split(n, k, i);
+		const size_t e = parallel::split(n, k, i + 1);
+		size_t h = b;
+		if (b != 0)
+			while (h != e && fn::bit(eq, f[h - 1], f[h])) ++h;
+		size_t heads = (h != e);
+		auto br2 = [&heads, eq](auto lhs, auto rhs) {
+			heads += !fn::bit(eq, lhs, rhs);
+			return true;
+		};
+		if (h != e) loop::adjacent_while(f + h, f + e, br2);
+		offset[i + 1] = heads;
+		lead[i] = h;
+	});
+	for (size_t i = 0; i < k; ++i) offset[i + 1] += offset[i];
+
+	// Each chunk reduces the segments it starts; the run before its
+	// first head is a partial sum of the previous chunk's last segment
+	std::vector<std::optional<T>> partial(k);
+	parallel::invoke(k, [&](size_t i) {
+		const size_t b = parallel::split(n, k, i);
+		const size_t e = parallel::split(n, k, i + 1);
+		const size_t h = lead[i];
+		if (h != b) {
+			T acc = v[b];
+			for (size_t j = b + 1; j != h; ++j)
+				acc = std::invoke(op, acc, v[j]);
+			partial[i] = acc;
+		}
+		loop::reduce_by_key(f + h, f + e, v + h, kout + offset[i],
+				    vout + offset[i], eq, op);
+	});
+	for (size_t i = 1; i < k; ++i) {
+		if (!partial[i]) continue;
+		auto slot = vout + (offset[i] - 1);
+		*slot = std::invoke(op, *slot, *partial[i]);
+	}
+	return {kout + offset[k], vout + offset[k]};
+}
+
 } // namespace loop
 
 #endif // !LOOP_STL_NUMERIC_HPP
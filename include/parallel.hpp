@@ -0,0 +1,70 @@
+#ifndef LOOP_STL_PARALLEL_HPP
+#define LOOP_STL_PARALLEL_HPP
+
+#include <algorithm>
+#include <functional>
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+
+#include "tuning.hpp"
+
+namespace loop {
+
+struct parallel_policy {
+	size_t threads = 0;
+};
+
+inline constexpr parallel_policy par{};
+
+namespace parallel {
+
+constexpr size_t grain = tuning::parallel_grain;
+
+inline size_t threads(parallel_policy policy) {
+	if (policy.threads != 0) return policy.threads;
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+inline size_t chunks(parallel_policy policy, size_t n) {
+	return std::max<size_t>(1, std::min(threads(policy), n / grain));
+}
+
+constexpr size_t split(size_t n, size_t k, size_t i) {
+	return n / k * i + n % k * i / k;
+}
+
+template <typename Fn1>
+void invoke(size_t k, Fn1 fn1) {
+	std::vector<std::thread> pool{};
+	pool.reserve(k);
+	for (size_t i = 1; i < k; ++i) pool.emplace_back(fn1, i);
+	if (k != 0) std::invoke(fn1, size_t{0});
+	for (auto & t : pool) t.join();
+}
+
+// Combines k runs, run i at [split(n, k, i), split(n, k, i + 1)), in
+// ceil(log2(k)) rounds; each round calls fn4(j, a, b, c) on pair j, runs
+// [a, b) and [b, c), in parallel, then fn0(). An odd run left over gets
+// b == c
+template <typename Fn4, typename Fn0>
+void rounds(size_t n, size_t k, Fn4 fn4, Fn0 fn0) {
+	std::vector<size_t> b(k + 1);
+	for (size_t i = 0; i <= k; ++i) b[i] = parallel::split(n, k, i);
+	while (b.size() > 2) {
+		const size_t m = b.size() - 1;
+		parallel::invoke((m + 1) / 2, [&b, m, fn4](size_t j) {
+			std::invoke(fn4, j, b[2 * j], b[std::min(2 * j + 1, m)],
+				    b[std::min(2 * j + 2, m)]);
+		});
+		for (size_t i = 1; i <= m / 2; ++i) b[i] = b[2 * i];
+		b[(m + 1) / 2] = b[m];
+		b.resize((m + 1) / 2 + 1);
+		std::invoke(fn0);
+	}
+}
+
+} // namespace parallel
+} // namespace loop
+
+#endif // !LOOP_STL_PARALLEL_HPP
@@ -0,0 +1,103 @@
+#ifndef LOOP_STL_RANDOM_HPP
+#define LOOP_STL_RANDOM_HPP
+
+#include <bit>
+#include <math.h>
+#include <stdint.h>
+
+namespace loop {
+
+namespace random {
+
+constexpr uint64_t splitmix64(uint64_t & state) {
+	uint64_t z = (state += 0x9e3779b97f4a7c15);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+struct xoshiro256pp {
+	using result_type = uint64_t;
+	uint64_t s[4];
+
+	constexpr explicit xoshiro256pp(uint64_t seed = 0) : s{} {
+		for (auto & word : s) word = random::splitmix64(seed);
+	}
+
+	static constexpr result_type min() { return 0; }
+	static constexpr result_type max() { return UINT64_MAX; }
+
+	constexpr result_type operator()() {
+		const uint64_t ret = std::rotl(s[0] + s[3], 23) + s[0];
+		const uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = std::rotl(s[3], 45);
+		return ret;
+	}
+
+	// Advances 2^128 steps: independent streams for parallel callers
+	constexpr void jump() {
+		constexpr uint64_t poly[] = {
+		    0x180ec6d33cfd0aba, 0xd5a61266f0c9392c,
+		    0xa9582618e03fc9aa, 0x39abdc4529b1661c};
+		uint64_t t[4] = {};
+		for (auto word : poly) {
+			for (int b = 0; b < 64; ++b) {
+				if (word & (uint64_t{1} << b)) {
+					for (int i = 0; i < 4; ++i) t[i] ^= s[i];
+				}
+				(*this)();
+			}
+		}
+		for (int i = 0; i < 4; ++i) s[i] = t[i];
+	}
+};
+
+__extension__ typedef unsigned __int128 uint128_t;
+
+template <typename G>
+constexpr uint64_t bits(G & g) {
+	static_assert(G::min() == 0 && G::max() == UINT64_MAX,
+		      "loop::random needs a 64-bit generator");
+	return g();
+}
+
+// Lemire's nearly divisionless method: uniform in [0, n)
+template <typename G>
+constexpr uint64_t bounded(G & g, uint64_t n) {
+	uint128_t m = uint128_t{random::bits(g)} * n;
+	if (static_cast<uint64_t>(m) < n) {
+		const uint64_t threshold = -n % n;
+		while (static_cast<uint64_t>(m) < threshold)
+			m = uint128_t{random::bits(g)} * n;
+	}
+	return static_cast<uint64_t>(m >> 64);
+}
+
+// Uniform in (0, 1]
+template <typename G>
+double unit(G & g) {
+	return static_cast<double>((random::bits(g) >> 11) + 1) * 0x1.0p-53;
+}
+
+template <typename G>
+struct coin {
+	G & g;
+	uint64_t word = 0;
+	int left = 0;
+
+	constexpr bool operator()() {
+		if (left == 0) word = random::bits(g), left = 64;
+		--left;
+		return (word >> left) & 1;
+	}
+};
+
+} // namespace random
+} // namespace loop
+
+#endif // !LOOP_STL_RANDOM_HPP
@@ -0,0 +1,63 @@
+#ifndef LOOP_STL_SEGMENTED_HPP
+#define LOOP_STL_SEGMENTED_HPP
+
+#include <deque>
+#include <type_traits>
+
+namespace loop {
+
+/* -----------------------
+ * Segmented iterators
+ *
+ * An iterator over a chunked container specializes
+ * `segmented_iterator_traits` with `segmented = true` and
+ *
+ * - segment_iterator, local_iterator
+ * - segment(it)          : the chunk holding `it`
+ * - local(it)            : position of `it` inside its chunk
+ * - begin(s), end(s)     : bounds of chunk `s`
+ * - compose(s, local)    : back to the outer iterator
+ *
+ * Loops then run over each chunk with its local (usually raw pointer)
+ * iterators and only step the outer iterator at chunk boundaries.
+ * Only the element loops are split this way: contiguous fast paths such
+ * as `equal`, `adjacent_find` and `unique_copy` still see a deque as a
+ * plain random-access range.
+ * ----------------------
+ */
+
+template <typename It>
+struct segmented_iterator_traits {
+	static constexpr bool segmented = false;
+};
+
+#if defined(__GLIBCXX__)
+
+template <typename T, typename Ref, typename Ptr>
+struct segmented_iterator_traits<std::_Deque_iterator<T, Ref, Ptr>> {
+	using iterator = std::_Deque_iterator<T, Ref, Ptr>;
+	using segment_iterator = typename iterator::_Map_pointer;
+	using local_iterator = Ptr;
+
+	static constexpr bool segmented = true;
+
+	static segment_iterator segment(iterator it) { return it._M_node; }
+	static local_iterator local(iterator it) { return it._M_cur; }
+	static local_iterator begin(segment_iterator s) { return *s; }
+	static local_iterator end(segment_iterator s) {
+		return *s + iterator::_S_buffer_size();
+	}
+	static iterator compose(segment_iterator s, local_iterator it) {
+		return iterator{const_cast<T *>(it), s};
+	}
+};
+
+#endif
+
+template <typename It, typename St = It>
+constexpr bool segmented =
+    std::is_same_v<It, St> && segmented_iterator_traits<It>::segmented;
+
+} // namespace loop
+
+#endif // !LOOP_STL_SEGMENTED_HPP
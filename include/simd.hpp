@@ -0,0 +1,203 @@
+#ifndef LOOP_STL_SIMD_HPP
+#define LOOP_STL_SIMD_HPP
+
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+#include <utility>
+
+#include "tuning.hpp"
+
+namespace loop {
+
+namespace simd {
+
+/* -----------------------
+ * Contiguous kernels
+ *
+ * Kernels work on raw pointers in fixed-width blocks of `lanes<T>`
+ * elements, so the block bodies have constant trip counts and lower
+ * to vector loads, permutes and stores under -march=native.
+ * ----------------------
+ */
+
+constexpr size_t width = 32;
+
+template <typename T>
+constexpr size_t lanes = (sizeof(T) < width) ? width / sizeof(T) : 1;
+
+template <typename It>
+concept contiguous =
+    std::contiguous_iterator<It> &&
+    std::is_trivially_copyable_v<std::iter_value_t<It>>;
+
+template <typename T>
+constexpr bool byte = sizeof(T) == 1 && (std::is_unsigned_v<T> ||
+					 std::is_same_v<T, std::byte>);
+
+template <typename ItL, typename ItR, typename T = std::iter_value_t<ItL>>
+constexpr bool comparable =
+    contiguous<ItL> && contiguous<ItR> &&
+    std::is_same_v<T, std::iter_value_t<ItR>> &&
+    (std::is_integral_v<T> || simd::byte<T>);
+
+// Elements ahead of the current one that indexed loops prefetch
+constexpr size_t prefetch_distance = tuning::prefetch_distance;
+
+// Bytes of source or destination kept cache-resident by blocked modes
+constexpr size_t cache_block = tuning::cache_block;
+
+template <int Rw = 0, typename T>
+void prefetch(const T * p) {
+	__builtin_prefetch(p, Rw, 3);
+}
+
+template <typename It>
+constexpr auto ptr(It it) {
+	return std::to_address(it);
+}
+
+// Blocks are staged as bytes, so T need not be default constructible
+template <typename T>
+void reverse(T * f, T * l) {
+	constexpr size_t w = lanes<T>, z = sizeof(T);
+	for (; static_cast<size_t>(l - f) >= 2 * w; f += w, l -= w) {
+		alignas(T) unsigned char lo[w * z], hi[w * z];
+		memcpy(lo, f, sizeof(lo));
+		memcpy(hi, l - w, sizeof(hi));
+		for (size_t k = 0; k < w; ++k)
+			memcpy(f + k, hi + (w - 1 - k) * z, z);
+		for (size_t k = 0; k < w; ++k)
+			memcpy(l - w + k, lo + (w - 1 - k) * z, z);
+	}
+	for (; f < l; ++f) std::swap(*f, *--l);
+}
+
+template <typename T>
+size_t mismatch(const T * lhs, const T * rhs, size_t n) {
+	constexpr size_t w = lanes<T>;
+	size_t i = 0;
+	for (; i + w <= n; i += w) {
+		unsigned diff = 0;
+		for (size_t k = 0; k < w; ++k) diff |= (lhs[i + k] != rhs[i + k]);
+		if (diff) break;
+	}
+	for (; i != n && lhs[i] == rhs[i]; ++i) {}
+	return i;
+}
+
+// Neighbouring pairs are compared a block at a time against the block
+// shifted by one lane; the scalar tail pins the exact position
+
+// First i with !br2(p[i], p[i + 1]), or n - 1 if there is none
+template <typename T, typename Br2>
+size_t adjacent(const T * p, size_t n, Br2 br2) {
+	constexpr size_t w = lanes<T>;
+	size_t i = 0;
+	for (; i + w < n; i += w) {
+		unsigned stop = 0;
+		for (size_t k = 0; k < w; ++k)
+			stop |= !std::invoke(br2, p[i + k], p[i + k + 1]);
+		if (stop) break;
+	}
+	for (; i + 1 < n && std::invoke(br2, p[i], p[i + 1]); ++i) {}
+	return i;
+}
+
+// Hands a kernel a raw pointer when `out` is contiguous over T
+template <typename T, typename OutIt, typename Fn1>
+OutIt output(OutIt out, Fn1 fn1) {
+	if constexpr (contiguous<OutIt>) {
+		if constexpr (std::is_same_v<std::iter_value_t<OutIt>, T>) {
+			auto q = simd::ptr(out);
+			return out + (std::invoke(fn1, q) - q);
+		}
+	}
+	return std::invoke(fn1, out);
+}
+
+template <typename T, typename OutIt>
+OutIt write(const T * tmp, size_t n, OutIt out) {
+	if constexpr (std::is_same_v<OutIt, T *>) {
+		memcpy(out, tmp, n * sizeof(T));
+		return out + n;
+	} else {
+		for (size_t k = 0; k < n; ++k, ++out) *out = tmp[k];
+		return out;
+	}
+}
+
+// p[0] and every p[i] that differs from p[i - 1], for n != 0
+template <typename T, typename OutIt>
+OutIt unique(const T * p, size_t n, OutIt out) {
+	constexpr size_t w = lanes<T>;
+	*out = p[0];
+	++out;
+	size_t i = 1;
+	for (; i + w <= n; i += w) {
+		unsigned keep = 0;
+		for (size_t k = 0; k < w; ++k)
+			keep += (p[i + k] != p[i + k - 1]);
+		if (keep == w) {
+			out = simd::write(p + i, w, out);
+			continue;
+		}
+		T tmp[w];
+		size_t j = 0;
+		for (size_t k = 0; k < w; ++k) {
+			tmp[j] = p[i + k];
+			j += (p[i + k] != p[i + k - 1]);
+		}
+		out = simd::write(tmp, j, out);
+	}
+	for (; i != n; ++i) {
+		if (p[i] != p[i - 1]) *out = p[i], ++out;
+	}
+	return out;
+}
+
+// p[0] and fn2(p[i], p[i - 1]) for n != 0; a pointer `out` is filled back
+// to front, so it may be `p`
+template <typename T, typename OutIt, typename Fn2>
+OutIt difference(const T * p, size_t n, OutIt out, Fn2 fn2) {
+	constexpr size_t w = lanes<T>;
+	if constexpr (std::is_same_v<OutIt, T *>) {
+		size_t i = n;
+		for (; i > w; i -= w) {
+			T res[w];
+			for (size_t k = 0; k < w; ++k)
+				res[k] = std::invoke(fn2, p[i - w + k],
+						     p[i - w + k - 1]);
+			memcpy(out + i - w, res, sizeof(res));
+		}
+		for (; i > 1; --i) out[i - 1] = std::invoke(fn2, p[i - 1], p[i - 2]);
+		out[0] = p[0];
+		return out + n;
+	} else {
+		*out = p[0];
+		++out;
+		size_t i = 1;
+		for (; i + w <= n; i += w) {
+			T res[w];
+			for (size_t k = 0; k < w; ++k)
+				res[k] = std::invoke(fn2, p[i + k], p[i + k - 1]);
+			out = simd::write(res, w, out);
+		}
+		for (; i != n; ++i, ++out) *out = std::invoke(fn2, p[i], p[i - 1]);
+		return out;
+	}
+}
+
+template <typename T>
+T * shift(T * f, T * l, T * out) {
+	memmove(out, f, (l - f) * sizeof(T));
+	return out + (l - f);
+}
+
+} // namespace simd
+} // namespace loop
+
+#endif // !LOOP_STL_SIMD_HPP
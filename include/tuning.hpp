@@ -0,0 +1,67 @@
+#ifndef LOOP_STL_TUNING_HPP
+#define LOOP_STL_TUNING_HPP
+
+#include <stdlib.h>
+
+/* -----------------------
+ * Tuning
+ *
+ * Thresholds default to values that suit most x86-64 parts. `make -C tune`
+ * measures them on the host and writes `tuning.generated.hpp` next to this
+ * file, which is picked up when present. Defining a macro before including
+ * the library overrides both.
+ *
+ * - LOOP_SORT_CUTOFF       : introsort hands ranges this small to a
+ *                            sorting network (3 to 32)
+ * - LOOP_LINEAR_SEARCH     : binary_find scans ranges this small linearly,
+ *                            at most that many extra predicate calls (<= 32)
+ * - LOOP_PARALLEL_GRAIN    : fewest elements worth a thread
+ * - LOOP_PREFETCH_DISTANCE : elements indexed loops prefetch ahead
+ * - LOOP_CACHE_BLOCK       : bytes blocked modes keep cache-resident
+ * ----------------------
+ */
+
+#if __has_include("tuning.generated.hpp")
+#include "tuning.generated.hpp"
+#endif
+
+#ifndef LOOP_SORT_CUTOFF
+#define LOOP_SORT_CUTOFF 16
+#endif
+
+#ifndef LOOP_LINEAR_SEARCH
+#define LOOP_LINEAR_SEARCH 8
+#endif
+
+#ifndef LOOP_PARALLEL_GRAIN
+#define LOOP_PARALLEL_GRAIN (1 << 12)
+#endif
+
+#ifndef LOOP_PREFETCH_DISTANCE
+#define LOOP_PREFETCH_DISTANCE 16
+#endif
+
+#ifndef LOOP_CACHE_BLOCK
+#define LOOP_CACHE_BLOCK (1 << 18)
+#endif
+
+namespace loop {
+
+namespace tuning {
+
+constexpr size_t sort_cutoff = LOOP_SORT_CUTOFF;
+constexpr size_t linear_search = LOOP_LINEAR_SEARCH;
+constexpr size_t parallel_grain = LOOP_PARALLEL_GRAIN;
+constexpr size_t prefetch_distance = LOOP_PREFETCH_DISTANCE;
+constexpr size_t cache_block = LOOP_CACHE_BLOCK;
+
+static_assert(sort_cutoff >= 3, "LOOP_SORT_CUTOFF below median of three");
+static_assert(sort_cutoff <= 32, "LOOP_SORT_CUTOFF above network::max");
+static_assert(linear_search <= 32, "LOOP_LINEAR_SEARCH above 32");
+static_assert(parallel_grain != 0, "LOOP_PARALLEL_GRAIN must be positive");
+static_assert(cache_block != 0, "LOOP_CACHE_BLOCK must be positive");
+
+} // namespace tuning
+} // namespace loop
+
+#endif // !LOOP_STL_TUNING_HPP
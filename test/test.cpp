@@ -1,11 +1,17 @@
 #include <array>
 #include <assert.h>
+#include <deque>
+#include <forward_list>
 #include <functional>
 #include <iostream>
+#include <list>
+#include <sstream>
 #include <stdio.h>
 #include <vector>
 
 #include "../include/algorithm.hpp"
+#include "../include/external.hpp"
+#include "../include/instrument.hpp"
 #include "../include/numeric.hpp"
 
 #define UNITTEST_MAIN
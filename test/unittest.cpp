@@ -3,11 +3,17 @@
 
 #include <array>
 #include <assert.h>
+#include <deque>
+#include <forward_list>
 #include <functional>
 #include <iostream>
+#include <list>
+#include <sstream>
 #include <vector>
 
 #include "../include/algorithm.hpp"
+#include "../include/external.hpp"
+#include "../include/instrument.hpp"
 #include "../include/numeric.hpp"
 
 #endif
@@ -59,6 +65,33 @@ unittest("count, count_if") {
 	ensure(1 == loop::count(a.cbegin(), a.cend(), 3));
 }
 
+unittest("histogram") {
+	LET_A();
+
+	std::array<int, 8> bins{};
+	loop::histogram(a.cbegin(), a.cend(), bins.begin(), bins.end());
+	ensure(same(bins.cbegin(), bins.cend(),
+		    std::array{0, 1, 1, 1, 2, 1, 1, 0}));
+
+	std::array<size_t, 2> parity{};
+	loop::histogram(a.cbegin(), a.cend(), parity.begin(), parity.end(),
+			odd);
+	ensure(4 == parity[0]);
+	ensure(3 == parity[1]);
+
+	std::vector<unsigned char> bytes(100000);
+	loop::random::xoshiro256pp g{9};
+	loop::generate(bytes.begin(), bytes.end(), [&g]() { return g(); });
+	std::vector<size_t> h(256), p(256);
+	loop::histogram(bytes.cbegin(), bytes.cend(), h.begin(), h.end());
+	ensure(bytes.size() == loop::reduce(h.cbegin(), h.cend(), size_t{0},
+					    std::plus{}));
+	ensure(loop::count(bytes.cbegin(), bytes.cend(), 'x') == h['x']);
+	loop::histogram(loop::parallel_policy{4}, bytes.cbegin(), bytes.cend(),
+			p.begin(), p.end());
+	ensure(h == p);
+}
+
 unittest("mismatch") {
 	LET_A();
 	LET_C();
@@ -78,9 +111,41 @@ unittest("find, find_if") {
 
 unittest("adjacent_find") {
 	LET_B();
+	LET_C();
 
 	ensure(std::next(b.cbegin(), 4) ==
 	       loop::adjacent_find(b.cbegin(), b.cend()));
+	ensure(c.cend() == loop::adjacent_find(c.cbegin(), c.cend()));
+	ensure(c.cend() == loop::adjacent_find(c.begin(), c.end()));
+}
+
+unittest("adjacent pairs: contiguous blocks") {
+	loop::random::xoshiro256pp g{3};
+	std::vector<short> v(300), o(300), p(300);
+	for (size_t n = 0; n < v.size(); ++n) {
+		loop::iota(v.begin(), v.begin() + n, short(-100));
+		if (n != 0) v[loop::random::bounded(g, n)] -= g() % 3;
+		auto f = v.cbegin(), l = v.cbegin() + n;
+
+		ensure(std::adjacent_find(f, l) == loop::adjacent_find(f, l));
+		ensure(std::is_sorted_until(f, l) ==
+		       loop::is_sorted_until(f, l));
+		ensure(std::is_sorted(f, l, std::greater{}) ==
+		       loop::is_sorted(f, l, std::greater{}));
+
+		auto e = std::unique_copy(f, l, p.begin());
+		ensure(std::equal(p.begin(), e, o.begin(),
+				  loop::unique_copy(f, l, o.begin())));
+
+		e = std::adjacent_difference(f, l, p.begin());
+		o.assign(f, l);
+		loop::adjacent_difference(o.begin(), o.end(), o.begin());
+		ensure(std::equal(p.begin(), e, o.begin(), o.end()));
+
+		std::vector<int> w(f, l);
+		loop::adjacent_difference(w.begin(), w.end(), w.begin());
+		ensure(std::equal(p.begin(), e, w.begin(), w.end()));
+	}
 }
 
 unittest("search, find_first_of") {
@@ -155,6 +220,41 @@ unittest("remove_copy(_if), replace_copy(_if)") {
 	o.clear();
 }
 
+unittest("gather, scatter, apply_permutation") {
+	loop::random::xoshiro256pp g{9};
+	for (size_t n : {0, 1, 100, 1 << 20}) {
+		std::vector<uint32_t> idx(n), src(n), o(n), p(n);
+		loop::iota(idx.begin(), idx.end(), 0);
+		loop::iota(src.begin(), src.end(), 1000);
+		loop::shuffle(idx.begin(), idx.end(), g);
+		for (size_t k = 0; k < n; ++k) p[k] = src[idx[k]];
+
+		loop::gather(idx.cbegin(), idx.cend(), src.cbegin(), o.begin());
+		ensure(p == o);
+		o.assign(n, 0);
+		loop::gather(loop::blocked, idx.cbegin(), idx.cend(), src.cbegin(),
+			     src.cend(), o.begin());
+		ensure(p == o);
+
+		o.assign(n, 0);
+		loop::scatter(p.cbegin(), p.cend(), idx.cbegin(), o.begin());
+		ensure(src == o);
+		o.assign(n, 0);
+		loop::scatter(loop::blocked, p.cbegin(), p.cend(), idx.cbegin(),
+			      o.begin(), o.end());
+		ensure(src == o);
+
+		o = src;
+		loop::apply_permutation(o.begin(), o.end(), idx.cbegin());
+		ensure(p == o);
+	}
+
+	std::vector<int> idx{3, 3, 0, 2}, src{10, 11, 12, 13}, o{};
+	loop::gather(loop::blocked, idx.cbegin(), idx.cend(), src.cbegin(),
+		     src.cend(), std::back_inserter(o));
+	ensure((std::vector{13, 13, 10, 12} == o));
+}
+
 unittest("generate, fill, generate_n, fill_n") {
 	LET_B();
 	LET_C();
@@ -185,6 +285,136 @@ unittest("generate, fill, generate_n, fill_n") {
 	o.clear();
 }
 
+unittest("reverse, rotate") {
+	LET_C();
+	LET_OUTPUT(o, out);
+
+	o.assign(c.crbegin(), c.crend());
+	loop::reverse(o.begin(), o.end());
+	ensure(same(c.cbegin(), c.cend(), o));
+	std::list<int> l(c.cbegin(), c.cend());
+	loop::reverse(l.begin(), l.end());
+	ensure(std::equal(l.cbegin(), l.cend(), c.crbegin()));
+	o.clear();
+
+	std::vector<int> v(1000);
+	loop::iota(v.begin(), v.end(), 0);
+	for (size_t k : {1, 3, 200, 500, 997}) {
+		o.assign(v.cbegin(), v.cend());
+		auto it = loop::rotate(o.begin(), std::next(o.begin(), k),
+				       o.end());
+		ensure(std::prev(o.end(), k) == it);
+		ensure(0 == *it);
+		ensure(std::is_sorted(o.begin(), it));
+		ensure(std::is_sorted(it, o.end()));
+	}
+	o.clear();
+
+	std::forward_list<int> fl(c.cbegin(), c.cend());
+	auto it = loop::rotate(fl.begin(), std::next(fl.begin(), 3), fl.end());
+	ensure(1 == *it);
+	ensure(4 == fl.front());
+	l.assign(c.cbegin(), c.cend());
+	ensure(1 == *loop::rotate(l.begin(), std::next(l.begin(), 3), l.end()));
+	ensure(4 == l.front());
+
+	std::vector<std::array<int, 16>> w(10);
+	for (size_t i = 0; i < w.size(); ++i) w[i][0] = i;
+	loop::rotate(w.begin(), std::next(w.begin(), 5), w.end());
+	ensure(5 == w.front()[0]);
+	ensure(4 == w.back()[0]);
+
+	struct point {
+		int x;
+		point(int x) : x(x) {}
+	};
+	std::vector<point> p(v.cbegin(), v.cend());
+	loop::reverse(p.begin(), p.end());
+	ensure(999 == p.front().x);
+	ensure(0 == p.back().x);
+	loop::rotate(p.begin(), std::next(p.begin(), 3), p.end());
+	ensure(996 == p.front().x);
+}
+
+unittest("shift_left, shift_right") {
+	LET_C();
+	LET_OUTPUT(o, out);
+
+	o.assign(c.cbegin(), c.cend());
+	auto it = loop::shift_left(o.begin(), o.end(), 2);
+	ensure(std::prev(o.end(), 2) == it);
+	ensure(same(std::next(c.cbegin(), 2), c.cend(),
+		    std::vector<int>(o.begin(), it)));
+	ensure(o.begin() == loop::shift_left(o.begin(), o.end(), 9));
+
+	o.assign(c.cbegin(), c.cend());
+	it = loop::shift_right(o.begin(), o.end(), 2);
+	ensure(std::next(o.begin(), 2) == it);
+	ensure(same(c.cbegin(), std::prev(c.cend(), 2),
+		    std::vector<int>(it, o.end())));
+	o.clear();
+
+	std::list<int> l(c.cbegin(), c.cend());
+	auto lt = loop::shift_right(l.begin(), l.end(), 3);
+	ensure(1 == *lt);
+
+	std::forward_list<int> fl(c.cbegin(), c.cend());
+	auto ft = loop::shift_right(fl.begin(), fl.end(), 2);
+	ensure(std::next(fl.begin(), 2) == ft);
+	ensure(same(c.cbegin(), std::prev(c.cend(), 2),
+		    std::vector<int>(ft, fl.end())));
+	ensure(fl.end() == loop::shift_right(fl.begin(), fl.end(), 9));
+}
+
+unittest("shuffle, random_shuffle, sample, reservoir_sample") {
+	LET_C();
+	LET_OUTPUT(o, out);
+
+	loop::random::xoshiro256pp g{42};
+
+	o.assign(c.cbegin(), c.cend());
+	loop::shuffle(o.begin(), o.end(), g);
+	ensure(std::is_permutation(o.cbegin(), o.cend(), c.cbegin()));
+	o.clear();
+
+	loop::sample(c.cbegin(), c.cend(), out, 3, g);
+	ensure(3 == o.size());
+	ensure(loop::is_sorted(o.cbegin(), o.cend()));
+	ensure(std::includes(c.cbegin(), c.cend(), o.cbegin(), o.cend()));
+	o.clear();
+
+	std::istringstream stream{"1 2 3 4 5 6 7"};
+	o.assign(3, 0);
+	auto end = loop::reservoir_sample(std::istream_iterator<int>{stream},
+					  std::istream_iterator<int>{},
+					  o.begin(), 3, g);
+	ensure(o.end() == end);
+	ensure(loop::all_of(o.cbegin(), o.cend(), loop::fn::lt(8)));
+	ensure(loop::none_of(o.cbegin(), o.cend(), loop::fn::lt(1)));
+	o.clear();
+
+	o.assign(1 << 15, 0);
+	loop::iota(o.begin(), o.end(), 0);
+	auto p = o;
+	loop::shuffle(loop::parallel_policy{4}, o.begin(), o.end(), g);
+	ensure(!std::equal(o.cbegin(), o.cend(), p.cbegin()));
+	ensure(std::is_permutation(o.cbegin(), o.cend(), p.cbegin()));
+
+	// Three runs merge unevenly; the first element still lands in each
+	// third about as often
+	o.resize(3 * loop::parallel::grain);
+	size_t first = 0;
+	for (size_t r = 0; r < 300; ++r) {
+		loop::iota(o.begin(), o.end(), 0);
+		loop::shuffle(loop::parallel_policy{3}, o.begin(), o.end(), g);
+		auto it = loop::find(o.cbegin(), o.cend(), 0);
+		first += static_cast<size_t>(it - o.cbegin()) <
+			 loop::parallel::grain;
+	}
+	ensure(60 < first && first < 140);
+	o.clear();
+}
+
 unittest("min_element, max_element, minmax_element") {
 	LET_A();
 
@@ -194,8 +424,51 @@ unittest("min_element, max_element, minmax_element") {
 
 unittest("equal") {
 	LET_A();
+	LET_C();
 
 	ensure(loop::equal(a.cbegin(), a.cend(), a.cbegin()));
+	ensure(!loop::equal(a.cbegin(), a.cend(), c.cbegin(), c.cend()));
+	ensure(!loop::equal(a.cbegin(), a.cend(), a.cbegin(),
+			    std::prev(a.cend())));
+
+	std::vector<int> e{};
+	ensure(loop::equal(e.cbegin(), e.cend(), e.cbegin()));
+	ensure(loop::equal(e.cbegin(), e.cend(), e.cbegin(), e.cend()));
+}
+
+unittest("lexicographical_compare, lexicographical_compare_three_way") {
+	LET_A();
+	LET_C();
+
+	ensure(loop::lexicographical_compare(a.cbegin(), a.cend(), c.cbegin(),
+					     c.cend()));
+	ensure(!loop::lexicographical_compare(c.cbegin(), c.cend(),
+					      a.cbegin(), a.cend()));
+	ensure(std::strong_ordering::less ==
+	       loop::lexicographical_compare_three_way(
+		   a.cbegin(), std::prev(a.cend()), a.cbegin(), a.cend()));
+	ensure(std::strong_ordering::greater ==
+	       loop::lexicographical_compare_three_way(c.cbegin(), c.cend(),
+						       a.cbegin(), a.cend()));
+
+	std::array<unsigned char, 4> x{1, 2, 200, 4}, y{1, 2, 3, 4};
+	ensure(loop::lexicographical_compare(y.cbegin(), y.cend(), x.cbegin(),
+					     x.cend()));
+	ensure(std::strong_ordering::equal ==
+	       loop::lexicographical_compare_three_way(x.cbegin(), x.cend(),
+						       x.cbegin(), x.cend()));
+	std::vector<unsigned char> e{};
+	ensure(std::strong_ordering::equal ==
+	       loop::lexicographical_compare_three_way(e.cbegin(), e.cend(),
+						       e.cbegin(), e.cend()));
+
+	std::list<int> l(c.cbegin(), c.cend());
+	ensure(loop::lexicographical_compare(l.cbegin(), l.cend(), l.cbegin(),
+					     l.cend(), std::greater{}) == false);
+	ensure(std::strong_ordering::greater ==
+	       loop::lexicographical_compare_three_way(l.cbegin(), l.cend(),
+						       l.cbegin(),
+						       std::prev(l.cend())));
 }
 
 unittest("is_partitioned, partition_point") {
@@ -226,6 +499,150 @@ unittest("is_sorted, is_sorted_until") {
 	ensure(last == loop::is_sorted_until(a.cbegin(), a.cend()));
 }
 
+unittest("sort, sorting networks") {
+	LET_A();
+	LET_OUTPUT(o, out);
+
+	constexpr auto sorted = [] {
+		std::array n{5, 3, 9, 1, 7, 2, 8, 6, 4, 0};
+		loop::sort(n);
+		return n;
+	}();
+	static_assert(loop::is_sorted(sorted.cbegin(), sorted.cend()));
+
+	loop::sort(a);
+	ensure(loop::is_sorted(a.cbegin(), a.cend()));
+	loop::sort(a, std::greater{});
+	ensure(6 == a.front());
+	ensure(1 == a.back());
+
+	loop::random::xoshiro256pp g{7};
+	for (size_t n : {0, 1, 2, 15, 16, 17, 33, 1000, 100000}) {
+		o.resize(n);
+		loop::generate(o.begin(), o.end(), [&g]() { return g() % 100; });
+		auto p = o;
+		loop::sort(o.begin(), o.end());
+		ensure(loop::is_sorted(o.cbegin(), o.cend()));
+		ensure(std::is_permutation(o.cbegin(), o.cend(), p.cbegin()));
+	}
+	o.clear();
+
+	auto check = [&g]<typename T>(T) {
+		for (size_t n = 0; n <= 2 * loop::tuning::sort_cutoff; ++n) {
+			std::vector<T> x(n);
+			loop::generate(x.begin(), x.end(),
+				       [&g]() { return T(int(g() % 200) - 100); });
+			auto y = x, z = x;
+			loop::sort(y.begin(), y.end());
+			loop::sort(z.begin(), z.end(), std::greater<T>{});
+			std::sort(x.begin(), x.end());
+			ensure(x == y);
+			ensure(std::equal(x.crbegin(), x.crend(), z.cbegin()));
+		}
+	};
+	check(int{});
+	check(int64_t{});
+	check(uint8_t{});
+	check(double{});
+}
+
+unittest("make_heap, push_heap, pop_heap, sort_heap, is_heap") {
+	LET_A();
+
+	loop::make_heap(a.begin(), a.end());
+	ensure(loop::is_heap(a.cbegin(), a.cend()));
+	ensure(6 == a.front());
+	loop::pop_heap(a.begin(), a.end());
+	ensure(6 == a.back());
+	ensure(loop::is_heap(a.cbegin(), std::prev(a.cend())));
+	ensure(std::prev(a.end()) == loop::is_heap_until(a.begin(), a.end()));
+	loop::push_heap(a.begin(), a.end());
+	ensure(loop::is_heap(a.cbegin(), a.cend()));
+	loop::sort_heap(a.begin(), a.end());
+	ensure(loop::is_sorted(a.cbegin(), a.cend()));
+}
+
+unittest("nth_element, partial_sort, partial_sort_copy, top_k") {
+	loop::random::xoshiro256pp g{11};
+	std::vector<int> v(100000);
+	loop::generate(v.begin(), v.end(), [&g]() { return g() % 1000; });
+	auto s = v;
+	std::sort(s.begin(), s.end());
+
+	for (size_t k : {0, 1, 17, 1000, 4000, 50000}) {
+		auto o = v;
+		loop::nth_element(o.begin(), o.begin() + k, o.end());
+		ensure(s[k] == o[k]);
+		ensure(loop::none_of(o.cbegin(), o.cbegin() + k,
+				     loop::fn::gt(s[k])));
+
+		o = v;
+		loop::partial_sort(o.begin(), o.begin() + k, o.end());
+		ensure(std::equal(o.cbegin(), o.cbegin() + k, s.cbegin()));
+
+		std::vector<int> r(k);
+		ensure(r.end() == loop::partial_sort_copy(v.cbegin(), v.cend(),
+							  r.begin(), r.end()));
+		ensure(r == std::vector(s.cbegin(), s.cbegin() + k));
+
+		ensure(r.end() == loop::top_k(v.cbegin(), v.cend(), k, r.begin(),
+					      std::greater{}));
+		ensure(std::equal(r.cbegin(), r.cend(), s.crbegin()));
+	}
+
+	std::istringstream in{"5 3 9 1 7 2 8"};
+	std::array<int, 8> r{};
+	auto e = loop::top_k(std::istream_iterator<int>{in}, std::default_sentinel,
+			     r.size(), r.begin());
+	ensure(7 == e - r.begin());
+	ensure((std::array{1, 2, 3, 5, 7, 8, 9, 0} == r));
+}
+
+unittest("merge, sort: parallel") {
+	using kv = std::pair<int, size_t>;
+	auto by_key = [](const kv & x, const kv & y) { return x.first < y.first; };
+	auto par = loop::parallel_policy{4};
+
+	loop::random::xoshiro256pp g{13};
+	for (auto [n1, n2] : {std::pair<size_t, size_t>{0, 0}, {1, 0}, {0, 7},
+			      {100, 3}, {50000, 70000}, {100000, 1}}) {
+		std::vector<kv> v1(n1), v2(n2);
+		size_t id = 0;
+		for (auto & x : v1) x = {int(g() % 100), id++};
+		for (auto & x : v2) x = {int(g() % 100), id++};
+		std::stable_sort(v1.begin(), v1.end(), by_key);
+		std::stable_sort(v2.begin(), v2.end(), by_key);
+		std::vector<kv> s(n1 + n2), o(n1 + n2), p(n1 + n2);
+		std::merge(v1.cbegin(), v1.cend(), v2.cbegin(), v2.cend(),
+			   s.begin(), by_key);
+		ensure(o.end() == loop::merge(v1.cbegin(), v1.cend(),
+					      v2.cbegin(), v2.cend(), o.begin(),
+					      by_key));
+		ensure(s == o);
+		ensure(p.end() == loop::merge(par, v1.cbegin(), v1.cend(),
+					      v2.cbegin(), v2.cend(), p.begin(),
+					      by_key));
+		ensure(s == p);
+	}
+
+	for (size_t n : {0, 1, 1000, 100000, 262147}) {
+		std::vector<int> o(n);
+		loop::generate(o.begin(), o.end(), [&g]() { return g() % 1000; });
+		auto s = o;
+		std::sort(s.begin(), s.end());
+		std::deque<int> d(o.cbegin(), o.cend());
+		for (size_t t : {3, 5, 6}) {
+			auto x = o;
+			loop::sort(loop::parallel_policy{t}, x.begin(), x.end());
+			ensure(s == x);
+		}
+		loop::sort(par, o.begin(), o.end());
+		ensure(s == o);
+		loop::sort(par, d.begin(), d.end(), std::greater{});
+		ensure(std::equal(d.cbegin(), d.cend(), s.crbegin()));
+	}
+}
+
 unittest("binary_search, lower_bound, upper_bound, equal_range") {
 	LET_B();
 
@@ -238,6 +655,69 @@ unittest("binary_search, lower_bound, upper_bound, equal_range") {
 	ensure(three_b == rng.f);
 	ensure(std::next(three_b, 3) == rng.l);
 	ensure(rng == loop::equal_range(b.cbegin(), b.cend(), 3));
+
+	std::vector<int> v(1000);
+	loop::iota(v.begin(), v.end(), 0);
+	for (int k : {-1, 0, 1, 500, 999, 1000}) {
+		auto lb = std::lower_bound(v.cbegin(), v.cend(), k);
+		ensure(lb == loop::binary_find<0>(v.cbegin(), v.cend(),
+						  loop::fn::lt(k)));
+		ensure(lb == loop::binary_find<64>(v.cbegin(), v.cend(),
+						   loop::fn::lt(k)));
+	}
+}
+
+unittest("lower_bound, upper_bound: interpolation, exponential") {
+	using loop::exponential;
+	using loop::interpolation;
+
+	loop::random::xoshiro256pp g{5};
+	std::vector<uint64_t> u(1 << 20), q(1000);
+	loop::generate(u.begin(), u.end(), [&g]() { return g() >> 24; });
+	loop::generate(q.begin(), q.end(), [&g]() { return g() >> 24; });
+	std::sort(u.begin(), u.end());
+	std::vector<uint64_t> e(u.size());
+	loop::transform(u.cbegin(), u.cend(), e.begin(),
+			[](uint64_t x) { return (x >> 20) * (x >> 20); });
+
+	loop::instrument::counters c{};
+	for (auto * v : {&u, &e}) {
+		auto [f, l] = loop::instrument::wrap(v->cbegin(), v->cend(), &c);
+		size_t probes = 0;
+		for (uint64_t k : q) {
+			const uint64_t x = (v == &u) ? k : (k >> 20) * (k >> 20);
+			c.reset();
+			auto lb = loop::lower_bound(interpolation, f, l, x);
+			probes += c.derefs;
+			ensure(3 * std::bit_width(v->size()) +
+				   loop::tuning::linear_search >=
+			       c.derefs);
+			ensure(lb.it == std::lower_bound(v->cbegin(), v->cend(), x));
+			ensure(std::upper_bound(v->cbegin(), v->cend(), x) ==
+			       loop::upper_bound(interpolation, f, l, x).it);
+			ensure(lb == l ||
+			       loop::binary_search(interpolation, f, l, *lb.it));
+			ensure(lb.it == loop::lower_bound(exponential, v->cbegin(),
+							  v->cend(), x));
+		}
+		if (v == &u) ensure(10 * q.size() > probes);
+	}
+
+	LET_B();
+	for (int k : {-1, 0, 1, 3, 4, 7}) {
+		auto lb = std::lower_bound(b.cbegin(), b.cend(), k);
+		auto ub = std::upper_bound(b.cbegin(), b.cend(), k);
+		ensure(lb == loop::lower_bound(interpolation, b.cbegin(),
+					       b.cend(), k));
+		ensure(ub == loop::upper_bound(interpolation, b.cbegin(),
+					       b.cend(), k));
+		ensure(lb == loop::lower_bound(exponential, b.cbegin(), b.cend(),
+					       k));
+		ensure(ub == loop::upper_bound(exponential, b.cbegin(), b.cend(),
+					       k));
+	}
+	auto n = loop::lower_bound(exponential, u.cbegin(), nullptr, u[12345]);
+	ensure(n == std::lower_bound(u.cbegin(), u.cend(), u[12345]));
 }
 
 unittest("iota") {
@@ -250,7 +730,7 @@ unittest("iota") {
 	o.clear();
 }
 
-unittest("reduce, transform_reduce, inner_product, adjancent_difference") {
+unittest("reduce, transform_reduce, inner_product, adjacent_difference") {
 	LET_A();
 	LET_C();
 	LET_OUTPUT(o, out);
@@ -264,6 +744,10 @@ unittest("reduce, transform_reduce, inner_product, adjancent_difference") {
 	loop::adjancent_difference(c.cbegin(), c.cend(), out, std::minus{});
 	ensure(all_of(o.cbegin(), o.cend(), loop::fn::eq(1)));
 	o.clear();
+
+	loop::adjacent_difference(c.cbegin(), c.cend(), out);
+	ensure(all_of(o.cbegin(), o.cend(), loop::fn::eq(1)));
+	o.clear();
 }
 
 unittest("inclusive_scan, exclusive_scan, partial_sum") {
@@ -282,6 +766,62 @@ unittest("inclusive_scan, exclusive_scan, partial_sum") {
 	o.clear();
 }
 
+unittest("reduce_by_key, inclusive_scan_by_key, exclusive_scan_by_key") {
+	LET_B();
+	LET_D();
+	LET_OUTPUT(o, out);
+	LET_OUTPUT(p, out_);
+
+	loop::reduce_by_key(b.cbegin(), b.cend(), d.cbegin(), out, out_,
+			    std::equal_to{}, std::plus{});
+	ensure(6 == o.size());
+	ensure(same(o.cbegin(), o.cend(), std::array{-1, 0, 1, 2, 3, 4}));
+	ensure(same(p.cbegin(), p.cend(), std::array{0, 1, 3, 6, 46, 28}));
+	o.clear();
+
+	loop::inclusive_scan_by_key(b.cbegin(), b.cend(), d.cbegin(), out,
+				    std::equal_to{}, std::plus{});
+	ensure(same(std::next(o.cbegin(), 4), o.cend(),
+		    std::array{10, 25, 46, 28}));
+	o.clear();
+	loop::exclusive_scan_by_key(b.cbegin(), b.cend(), d.cbegin(), out, 0,
+				    std::equal_to{}, std::plus{});
+	ensure(same(std::next(o.cbegin(), 3), o.cend(),
+		    std::array{0, 0, 10, 25, 0}));
+	o.clear();
+
+	std::vector<int> k(1 << 16), v(k.size());
+	loop::random::xoshiro256pp g{3};
+	int key = 0;
+	loop::generate(k.begin(), k.end(),
+		       [&g, &key]() { return key += (g() % 64 == 0); });
+	loop::fill(std::next(k.begin(), 10000), std::next(k.begin(), 40000), -1);
+	loop::generate(v.begin(), v.end(), [&g]() { return g() % 100; });
+	auto par = loop::parallel_policy{4};
+	std::vector<int> x(k.size()), y(k.size()), z(k.size()), w(k.size());
+
+	auto [kx, vx] = loop::reduce_by_key(k.cbegin(), k.cend(), v.cbegin(),
+					    x.begin(), y.begin(),
+					    std::equal_to{}, std::plus{});
+	auto [kz, vz] = loop::reduce_by_key(par, k.cbegin(), k.cend(),
+					    v.cbegin(), z.begin(), w.begin(),
+					    std::equal_to{}, std::plus{});
+	ensure(kx - x.begin() == kz - z.begin());
+	ensure(std::equal(x.begin(), kx, z.begin()));
+	ensure(std::equal(y.begin(), vx, w.begin()));
+
+	loop::inclusive_scan_by_key(k.cbegin(), k.cend(), v.cbegin(),
+				    x.begin(), std::equal_to{}, std::plus{});
+	loop::inclusive_scan_by_key(par, k.cbegin(), k.cend(), v.cbegin(),
+				    z.begin(), std::equal_to{}, std::plus{});
+	ensure(x == z);
+	loop::exclusive_scan_by_key(k.cbegin(), k.cend(), v.cbegin(),
+				    x.begin(), 1, std::equal_to{}, std::plus{});
+	loop::exclusive_scan_by_key(par, k.cbegin(), k.cend(), v.cbegin(),
+				    z.begin(), 1, std::equal_to{}, std::plus{});
+	ensure(x == z);
+}
+
 unittest("transform_inclusive_scan, transform_exclusive_scan") {
 	LET_C();
 	LET_D();
@@ -296,3 +836,123 @@ unittest("transform_inclusive_scan, transform_exclusive_scan") {
 	ensure(same(d.cbegin(), std::prev(d.cend()), o));
 	o.clear();
 }
+
+unittest("instrument: complexity bounds") {
+	using loop::instrument::counters;
+	using value = loop::instrument::value<int>;
+
+	counters c{};
+	std::vector<value> v{};
+	for (int i = 0; i < 1000; ++i) v.push_back(value{i, &c});
+
+	for (int k : {-1, 0, 1, 500, 999, 1000}) {
+		c.reset();
+		loop::lower_bound(v.cbegin(), v.cend(), value{k, &c});
+		ensure(c.compares <= std::bit_width(v.size()) + 1);
+	}
+
+	loop::shuffle(v.begin(), v.end(), loop::random::xoshiro256pp{1});
+	c.reset();
+	auto [min, max] = loop::minmax_element(v.cbegin(), v.cend());
+	ensure(0 == min->val);
+	ensure(999 == max->val);
+	ensure(c.compares <= 3 * v.size() / 2);
+
+	std::list<int> l(v.size());
+	auto [f, t] = loop::instrument::wrap(l.begin(), l.end(), &c);
+	c.reset();
+	loop::for_each(f, t, [](auto) {});
+	ensure(v.size() == c.increments);
+	ensure(v.size() == c.derefs);
+
+	LET_A();
+	c.reset();
+	loop::find_if(a.cbegin(), a.cend(),
+		      loop::instrument::function{loop::fn::eq(3), &c});
+	ensure(3 == c.calls);
+
+	std::vector<int> w{5, 5, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10};
+	w.resize(100, 11);
+	c.reset();
+	ensure(w.begin() ==
+	       loop::adjacent_find(w.begin(), w.end(),
+				   loop::instrument::function{std::equal_to{},
+							      &c}));
+	ensure(1 == c.calls);
+	c.reset();
+	ensure(std::next(w.begin(), 2) ==
+	       loop::is_sorted_until(w.begin(), w.end(),
+				     loop::instrument::function{std::less{},
+								&c}));
+	ensure(2 == c.calls);
+}
+
+unittest("external: mapped, sort") {
+	using loop::external::mapped;
+
+	// Per process, so concurrent test runs do not share files
+	char in[64], out[64];
+	snprintf(in, sizeof(in), "/tmp/loop_stl_external.%d.in", getpid());
+	snprintf(out, sizeof(out), "/tmp/loop_stl_external.%d.out", getpid());
+	const size_t n = 1 << 18;
+	uint64_t sum = 0;
+	{
+		mapped<uint32_t> m{in, n};
+		loop::random::xoshiro256pp g{5};
+		loop::generate(m.begin(), m.end(), [&g]() { return g(); });
+		sum = loop::accumulate(m.begin(), m.end(), uint64_t{0},
+				       std::plus{});
+	}
+	for (size_t memory : {1 << 10, 1 << 14, 1 << 18, 1 << 22}) {
+		loop::external::sort<uint32_t>(in, out, memory);
+		mapped<uint32_t> m{out};
+		ensure(n == m.size());
+		ensure(loop::is_sorted(m.begin(), m.end()));
+		ensure(sum == loop::accumulate(m.begin(), m.end(), uint64_t{0},
+					       std::plus{}));
+	}
+
+	// The lowest free descriptor moves if a failed sort leaks its runs
+	const int fd = dup(0);
+	close(fd);
+	bool thrown = false;
+	try {
+		loop::external::sort<uint32_t>(in, "/nonexistent/out", 1 << 14);
+	} catch (const std::system_error &) {
+		thrown = true;
+	}
+	ensure(thrown);
+	const int after = dup(0);
+	close(after);
+	ensure(fd == after);
+	remove(in);
+	remove(out);
+}
+
+#if defined(__GLIBCXX__)
+static_assert(loop::segmented<std::deque<int>::iterator>);
+static_assert(loop::segmented<std::deque<int>::const_iterator>);
+#endif
+static_assert(!loop::segmented<std::vector<int>::iterator>);
+
+unittest("segmented: deque") {
+	std::deque<int> d(10000);
+	LET_OUTPUT(o, out);
+
+	loop::fill(d.begin(), d.end(), 1);
+	ensure(10000 == loop::count(d.cbegin(), d.cend(), 1));
+	loop::iota(d.begin(), d.end(), 0);
+	ensure(std::next(d.cbegin(), 4321) ==
+	       loop::find(d.cbegin(), d.cend(), 4321));
+	ensure(d.cend() == loop::find(d.cbegin(), d.cend(), -1));
+	ensure(49995000 == loop::reduce(d.cbegin(), d.cend(), 0, std::plus{}));
+
+	auto f = std::next(d.cbegin(), 1000);
+	auto l = std::next(d.cbegin(), 1003);
+	loop::copy(f, l, out);
+	ensure(same(f, l, o));
+	ensure(loop::equal(d.cbegin(), d.cend(), d.cbegin()));
+	ensure(std::next(d.cbegin(), 2) ==
+	       loop::for_each_n(d.cbegin(), 2, [](auto) {}));
+	o.clear();
+}
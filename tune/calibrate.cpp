@@ -0,0 +1,162 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "../bench/perf.hpp"
+#include "../include/algorithm.hpp"
+#include "../include/numeric.hpp"
+
+/* -----------------------
+ * Calibration
+ *
+ * Times each tuning candidate on this host and writes the fastest as a
+ * header of macro defaults. Usage: ./calibrate.out [out] [n]
+ * ----------------------
+ */
+
+// The first candidate within 2% of the fastest, so noise does not push the
+// choice to an extreme
+template <typename T, size_t N>
+size_t fastest(const std::array<T, N> & cands, const std::array<double, N> & ns,
+	       const char * name) {
+	double min = ns[0];
+	for (size_t i = 0; i < N; ++i) {
+		fprintf(stderr, "%-18s %8zu %10.3f ns\n", name, size_t(cands[i]),
+			ns[i]);
+		min = std::min(min, ns[i]);
+	}
+	size_t i = 0;
+	while (ns[i] > 1.02 * min) ++i;
+	return cands[i];
+}
+
+// Median of several timings, so a single preempted run cannot decide
+template <typename Fn0>
+double median(size_t runs, size_t reps, Fn0 fn0) {
+	std::vector<double> ns(runs);
+	for (double & t : ns) t = bench::measure(reps, fn0).ns;
+	std::nth_element(ns.begin(), ns.begin() + runs / 2, ns.end());
+	return ns[runs / 2];
+}
+
+size_t sort_cutoff(size_t n) {
+	constexpr std::array<size_t, 7> cands{4, 8, 12, 16, 20, 24, 32};
+	std::vector<int> keys(n), buf(n);
+	loop::random::xoshiro256pp g{1};
+	loop::generate(keys.begin(), keys.end(), [&g]() { return g(); });
+	std::array<double, cands.size()> ns{};
+	[&]<size_t... I>(std::index_sequence<I...>) {
+		((ns[I] = bench::measure(4, [&]() {
+				  loop::copy(keys.begin(), keys.end(),
+					     buf.begin());
+				  loop::introsort<cands[I]>(
+				      buf.begin(), buf.end(), std::less<>{},
+				      2 * std::bit_width(n));
+			  }).ns / n),
+		 ...);
+	}(std::make_index_sequence<cands.size()>{});
+	return fastest(cands, ns, "sort cutoff");
+}
+
+// Timed on a cache-resident array: on a large one misses dominate and hide
+// the compare cost being tuned. Every candidate adds as many predicate calls
+// to each search, so the list stops at 32
+size_t linear_search() {
+	constexpr std::array<size_t, 5> cands{0, 4, 8, 16, 32};
+	constexpr size_t n = 1 << 12, queries = 1 << 14;
+	std::vector<int> keys(n), q(queries);
+	loop::iota(keys.begin(), keys.end(), 0);
+	loop::random::xoshiro256pp g{2};
+	loop::generate(q.begin(), q.end(),
+		       [&g]() { return loop::random::bounded(g, n); });
+	std::array<double, cands.size()> ns{};
+	[&]<size_t... I>(std::index_sequence<I...>) {
+		((ns[I] = median(9, 4, [&]() {
+				  for (int k : q)
+					  bench::keep(loop::binary_find<cands[I]>(
+					      keys.begin(), keys.end(),
+					      loop::fn::lt(k)));
+			  }) / queries),
+		 ...);
+	}(std::make_index_sequence<cands.size()>{});
+	return fastest(cands, ns, "linear search");
+}
+
+// Smallest power of two for which starting a thread costs at most a quarter
+// of the work it is given
+size_t parallel_grain(size_t n) {
+	std::vector<int> v(n);
+	loop::iota(v.begin(), v.end(), 0);
+	const double elt = bench::measure(8, [&]() {
+				   bench::keep(loop::accumulate(
+				       v.begin(), v.end(), 0L, std::plus{}));
+			   }).ns / n;
+	const double spawn = bench::measure(64, []() {
+				     loop::parallel::invoke(2, [](size_t) {});
+			     }).ns;
+	const double grain = 4 * spawn / elt;
+	fprintf(stderr, "%-18s %8.3f ns/element, %.0f ns/thread\n",
+		"parallel grain", elt, spawn);
+	return std::bit_ceil(
+	    std::clamp<size_t>(static_cast<size_t>(grain), 1 << 10, 1 << 24));
+}
+
+size_t prefetch_distance(size_t n) {
+	constexpr std::array<size_t, 7> cands{0, 2, 4, 8, 16, 32, 64};
+	std::vector<uint32_t> idx(n);
+	std::vector<uint64_t> src(n), out(n);
+	loop::iota(idx.begin(), idx.end(), 0);
+	loop::iota(src.begin(), src.end(), 0);
+	loop::shuffle(idx.begin(), idx.end(), loop::random::xoshiro256pp{3});
+	std::array<double, cands.size()> ns{};
+	for (size_t i = 0; i < cands.size(); ++i) {
+		ns[i] = bench::measure(2, [&]() {
+				loop::gather(idx.begin(), idx.end(),
+					     src.begin(), out.begin(), cands[i]);
+				bench::keep(out);
+			}).ns / n;
+	}
+	return fastest(cands, ns, "prefetch distance");
+}
+
+// Half the L2, leaving room for the indices and output streams
+size_t cache_block() {
+	const long l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	fprintf(stderr, "%-18s %8ld bytes\n", "L2", l2);
+	if (l2 <= 0) return loop::tuning::cache_block;
+	return std::bit_floor(static_cast<size_t>(l2) / 2);
+}
+
+int main(int argc, const char * argv[]) {
+	FILE * out = (argc > 1) ? fopen(argv[1], "w") : stdout;
+	const size_t n = (argc > 2) ? strtoull(argv[2], nullptr, 0) : 1 << 23;
+	if (!out) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	const std::array<std::pair<const char *, size_t>, 5> macros{{
+	    {"LOOP_SORT_CUTOFF", sort_cutoff(n / 8)},
+	    {"LOOP_LINEAR_SEARCH", linear_search()},
+	    {"LOOP_PARALLEL_GRAIN", parallel_grain(n)},
+	    {"LOOP_PREFETCH_DISTANCE", prefetch_distance(n)},
+	    {"LOOP_CACHE_BLOCK", cache_block()},
+	}};
+
+	fprintf(out, "// Generated by tune/calibrate.out: rerun `make -C tune`"
+		     " on new hardware\n");
+	fprintf(out, "#ifndef LOOP_STL_TUNING_GENERATED_HPP\n"
+		     "#define LOOP_STL_TUNING_GENERATED_HPP\n");
+	for (auto [name, val] : macros) {
+		fprintf(out, "\n#ifndef %s\n#define %s %zu\n#endif\n", name,
+			name, val);
+	}
+	fprintf(out, "\n#endif // !LOOP_STL_TUNING_GENERATED_HPP\n");
+	if (out != stdout) fclose(out);
+	return 0;
+}